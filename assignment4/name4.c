@@ -1,7 +1,10 @@
 #include <stdlib.h> // malloc
 #include <stdio.h>
 #include <string.h> // strdup, strcmp
-#include <ctype.h> // toupper
+#include <ctype.h> // toupper, isspace
+#include <time.h> // clock_gettime
+#include <unistd.h> // fsync, truncate, access, close, _exit
+#include <fcntl.h> // open
 
 #define QUIT			1
 #define FORWARD_PRINT	2
@@ -9,6 +12,22 @@
 #define SEARCH			4
 #define DELETE			5
 #define COUNT			6
+#define ADD				7
+#define MAX_ACTION		7
+
+#define PROMPT	"Select Q)uit, P)rint, B)ackward print, S)earch, A)dd, D)elete, C)ount: "
+
+#define BATCH_BUFSIZE	(1 << 16)	// stdout buffer size in batch mode
+#define MAX_LINE		256
+
+// persistence (write-ahead log and checkpoint)
+#define WAL_ADD				'A'
+#define WAL_REMOVE			'R'
+#define GROUP_COMMIT		64			// log records per fsync
+#define CHECKPOINT_INTERVAL	100000		// log records between checkpoints
+#define CKPT_MAGIC			"NCK1"
+#define IO_BUFSIZE			(1 << 20)	// stdio buffer for sequential I/O
+#define MAX_NAME			65535
 
 // User structure type definition
 typedef struct 
@@ -17,6 +36,44 @@ typedef struct
 	int		freq;	// 빈도
 } tName;
 
+// Command statistics for batch mode
+typedef struct
+{
+	int			count[MAX_ACTION + 1];	// 명령별 실행 횟수 (index 0: undefined)
+	long long	*latency;			// 명령별 실행 시간 (ns)
+	int			len;
+	int			capacity;
+} tStat;
+
+// Write-ahead log and checkpoint
+// PREFIX.ckpt	binary snapshot of (name, freq) in list order
+// PREFIX.log	append-only log of add/remove operations after the snapshot
+// every log record carries a sequence number (lsn) and the checkpoint stores
+// the lsn it includes, so replay never applies an operation twice
+typedef struct
+{
+	FILE				*log;			// operation log (append)
+	FILE				*ckpt;			// checkpoint being written
+	char				*logPath;
+	char				*ckptPath;
+	char				*tmpPath;		// checkpoint is renamed from here when complete
+	unsigned long long	lsn;			// sequence number of the last record
+	int					pending;		// records written but not synced
+	int					records;		// records since the last checkpoint
+	int					groupCommit;	// records per fsync
+	int					checkpointAt;	// records at which log_op takes the next checkpoint
+} WAL;
+
+// log record read back for replay
+typedef struct
+{
+	unsigned long long	lsn;
+	size_t				offset;	// of the name in the buffer of all names
+	const char			*name;	// set once all names are read
+	int					freq;
+	int					op;
+} LOGREC;
+
 ////////////////////////////////////////////////////////////////////////////////
 // LIST type definition
 typedef struct node
@@ -102,11 +159,72 @@ tName *createName( char *name, int freq);
 void destroyName( tName *pNode);
 
 ////////////////////////////////////////////////////////////////////////////////
-// gets user's input
-int get_action()
+// executes one command (except QUIT) on the list
+//	name	name (S, A, D)
+//	arg2	freq (A)
+// wal is NULL if the list is not persistent
+void run_action( LIST *list, WAL *wal, int action, char *name, char *arg2);
+
+// reads commands from script and executes them without prompts
+// a command per line: S name, A name freq, D name, C, P, B, Q
+//	return	0 if overflow
+//			1 if successful
+int run_batch( LIST *list, WAL *wal, FILE *script);
+
+// checkpoints persistent state and recycles memory of list and wal
+void quit( LIST *list, WAL *wal);
+
+// appends an operation to the log; takes a checkpoint every CHECKPOINT_INTERVAL records
+// (a failed checkpoint is tried again CHECKPOINT_INTERVAL records later)
+// the program stops if the log cannot be written (fail_log)
+void log_op( LIST *list, WAL *wal, int op, char *name, int freq);
+
+// the log cannot be written or synced: stops without releasing the results
+// not acknowledged yet
+void fail_log( void);
+
+// syncs the log, then releases the results of the commands it covers (stdout)
+void commit_results( WAL *wal);
+
+////////////////////////////////////////////////////////////////////////////////
+// Allocates WAL for files PREFIX.log and PREFIX.ckpt
+// return	WAL pointer
+// 			NULL if overflow
+WAL *wal_Open( const char *prefix, int groupCommit);
+
+// Syncs the log and recycles memory
+void wal_Close( WAL *wal);
+
+// return 1 if a checkpoint or log exists; 0 if not
+int wal_Exists( WAL *wal);
+
+// Loads the checkpoint (appended to list) and replays the log records after it
+// in name order (one merge pass over the list), then opens the log for appending
+// return	number of replayed log records
+// 			-1 if error
+int wal_Recover( WAL *wal, LIST *list);
+
+// Appends an operation (WAL_ADD or WAL_REMOVE) to the log
+// the log is synced every groupCommit records; callers sync (wal_Sync) before
+// they acknowledge the operation
+// return	1 success
+// 			0 I/O error
+int wal_Append( WAL *wal, int op, const char *name, int freq);
+
+// Flushes and syncs pending log records
+// return	1 success
+// 			0 I/O error
+int wal_Sync( WAL *wal);
+
+// Writes all names in list order to a new checkpoint, then truncates the log
+// return	1 success
+// 			0 I/O error
+int wal_Checkpoint( WAL *wal, LIST *list);
+
+////////////////////////////////////////////////////////////////////////////////
+// converts a command character to action
+int char_to_action( char ch)
 {
-	char ch;
-	scanf( "%c", &ch);
 	ch = toupper( ch);
 	switch( ch)
 	{
@@ -122,10 +240,20 @@ int get_action()
 			return DELETE;
 		case 'C':
 			return COUNT;
+		case 'A':
+			return ADD;
 	}
 	return 0; // undefined action
 }
 
+// gets user's input
+int get_action()
+{
+	char ch;
+	if (scanf( "%c", &ch) == EOF) return QUIT;
+	return char_to_action( ch);
+}
+
 // compares two names in name structures
 // for createList function
 int cmpName( const tName *pName1, const tName *pName2)
@@ -151,24 +279,34 @@ void increase_freq(tName *dataOutPtr, const tName *dataInPtr)
 int main( int argc, char **argv)
 {
 	LIST *list;
+	WAL *wal = NULL;
 	
 	char name[100];
+	char arg2[100];
 	int freq;
 	
 	tName *pName;
 	int ret;
+	int i;
 	FILE *fp;
+	FILE *script = NULL;
+	char *prefix = NULL;
 	
-	if (argc != 2){
-		fprintf( stderr, "usage: %s FILE\n", argv[0]);
-		return 1;
+	for (i = 1; i + 1 < argc && argv[i][0] == '-'; i += 2){
+		if (strcmp( argv[i], "-b") == 0){
+			script = fopen( argv[i + 1], "rt");
+			if (!script)
+			{
+				fprintf( stderr, "Error: cannot open file [%s]\n", argv[i + 1]);
+				return 2;
+			}
+		}
+		else if (strcmp( argv[i], "-w") == 0) prefix = argv[i + 1];
+		else break;
 	}
-	
-	fp = fopen( argv[1], "rt");
-	if (!fp)
-	{
-		fprintf( stderr, "Error: cannot open file [%s]\n", argv[1]);
-		return 2;
+	if (i != argc - 1){
+		fprintf( stderr, "usage: %s [-b SCRIPT] [-w PREFIX] FILE\n", argv[0]);
+		return 1;
 	}
 	
 	// creates an empty list
@@ -179,77 +317,314 @@ int main( int argc, char **argv)
 		return 100;
 	}
 	
-	while(fscanf( fp, "%*d\t%s\t%*c\t%d", name, &freq) != EOF)
-	{
-		pName = createName( name, freq);
-		ret = addNode( list, pName);
-		if (ret == 2) // duplicated
+	if (prefix){
+		wal = wal_Open( prefix, GROUP_COMMIT);
+		if (!wal)
 		{
-			destroyName( pName);
+			printf( "Cannot create log\n");
+			return 100;
+		}
+	}
+	
+	// restarts from the newest checkpoint and the log tail
+	if (wal && wal_Exists( wal)){
+		if (wal_Recover( wal, list) < 0)
+		{
+			fprintf( stderr, "Error: cannot recover [%s]\n", prefix);
+			return 3;
+		}
+	}
+	else{
+		fp = fopen( argv[i], "rt");
+		if (!fp)
+		{
+			fprintf( stderr, "Error: cannot open file [%s]\n", argv[i]);
+			return 2;
+		}
+		
+		while(fscanf( fp, "%*d\t%s\t%*c\t%d", name, &freq) != EOF)
+		{
+			pName = createName( name, freq);
+			ret = addNode( list, pName);
+			if (ret == 2) // duplicated
+			{
+				destroyName( pName);
+			}
+		}
+		
+		fclose( fp);
+		
+		// first checkpoint of the persistent state
+		if (wal && (wal_Recover( wal, list) < 0 || !wal_Checkpoint( wal, list)))
+		{
+			fprintf( stderr, "Error: cannot write checkpoint [%s]\n", prefix);
+			return 3;
 		}
 	}
 	
-	fclose( fp);
+	if (script)
+	{
+		ret = run_batch( list, wal, script);
+		fclose( script);
+		quit( list, wal);
+		return ret ? 0 : 100;
+	}
 	
-	fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
+	// results wait in stdout until their log records are synced
+	if (wal) setvbuf( stdout, NULL, _IOFBF, BATCH_BUFSIZE);
+	
+	fprintf( stderr, PROMPT);
 	
 	while (1)
 	{
-		tName *ptr;
 		int action = get_action();
 		
 		switch( action)
 		{
 			case QUIT:
-				destroyList( list);
+				quit( list, wal);
 				return 0;
 			
-			case FORWARD_PRINT:
-				traverseList( list, print_name);
-				break;
-			
-			case BACKWARD_PRINT:
-				traverseListR( list, print_name);
-				break;
-			
 			case SEARCH:
 				fprintf( stderr, "Input a name to find: ");
 				fscanf( stdin, "%s", name);
-				
-				pName = createName( name, 0);
-
-				if (searchList( list, pName, &ptr)) print_name( ptr);
-				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName);
+				break;
+			
+			case ADD:
+				fprintf( stderr, "Input a name and freq to add: ");
+				fscanf( stdin, "%s %s", name, arg2);
 				break;
 				
 			case DELETE:
 				fprintf( stderr, "Input a name to delete: ");
 				fscanf( stdin, "%s", name);
-				
-				pName = createName( name, 0);
+				break;
+		}
+		run_action( list, wal, action, name, arg2);
+		commit_results( wal);
+		
+		if (action) fprintf( stderr, PROMPT);
+	}
+	return 0;
+}
 
-				if (removeNode( list, pName, &ptr))
-				{
-					fprintf( stdout, "(%s, %d) deleted\n", ptr->name, ptr->freq);
-					destroyName( ptr);
-				}
-				else fprintf( stdout, "%s not found\n", name);
-				
+// checkpoints persistent state and recycles memory of list and wal
+void quit( LIST *list, WAL *wal){
+	if (wal){
+		if (!wal_Checkpoint( wal, list)) fprintf( stderr, "Error: cannot write checkpoint\n");
+		wal_Close( wal);
+	}
+	destroyList( list);
+}
+
+// the log cannot be written or synced: the results not acknowledged yet are
+// discarded (_exit does not flush stdout) and so is the state in memory
+void fail_log( void){
+	fprintf( stderr, "Error: cannot write log; unacknowledged results are discarded\n");
+	_exit( 3);
+}
+
+// appends an operation to the log; takes a checkpoint every CHECKPOINT_INTERVAL records
+// (a failed checkpoint is tried again CHECKPOINT_INTERVAL records later)
+// the program stops if the log cannot be written (fail_log)
+void log_op( LIST *list, WAL *wal, int op, char *name, int freq){
+	if (!wal) return;
+	
+	if (!wal_Append( wal, op, name, freq))
+		fail_log();
+	else if (wal->records >= wal->checkpointAt){
+		if (wal_Checkpoint( wal, list)) wal->checkpointAt = CHECKPOINT_INTERVAL;
+		else{
+			fprintf( stderr, "Error: cannot write checkpoint\n");
+			wal->checkpointAt = wal->records + CHECKPOINT_INTERVAL;
+		}
+	}
+}
+
+// syncs the log, then releases the results of the commands it covers (stdout)
+// so that no add or delete is acknowledged before its record is on disk
+// the program stops if the log cannot be synced (fail_log)
+void commit_results( WAL *wal){
+	if (wal && !wal_Sync( wal)) fail_log();
+	fflush( stdout);
+}
+
+// executes one command (except QUIT) on the list
+//	name	name (S, A, D)
+//	arg2	freq (A)
+// wal is NULL if the list is not persistent
+void run_action( LIST *list, WAL *wal, int action, char *name, char *arg2){
+	tName *ptr;
+	tName *pName;
+	tName key = { name, 0}; // borrowed key for searching
+	int ret;
+	
+	switch( action)
+	{
+		case FORWARD_PRINT:
+			traverseList( list, print_name);
+			break;
+		
+		case BACKWARD_PRINT:
+			traverseListR( list, print_name);
+			break;
+		
+		case SEARCH:
+			pName = createName( name, 0);
+
+			if (searchList( list, pName, &ptr)) print_name( ptr);
+			else fprintf( stdout, "%s not found\n", name);
+			
+			destroyName( pName);
+			break;
+			
+		case ADD:
+			pName = createName( name, atoi( arg2));
+			
+			ret = addNode( list, pName);
+			if (ret == 0){
+				fprintf( stdout, "cannot add %s\n", name);
 				destroyName( pName);
 				break;
+			}
+			log_op( list, wal, WAL_ADD, name, pName->freq);
+			if (ret == 2) destroyName( pName); // duplicated
 			
-			case COUNT:
-				fprintf( stdout, "%d\n", countList( list));
-				break;
-		}
+			if (searchList( list, &key, &ptr)) print_name( ptr);
+			break;
+			
+		case DELETE:
+			pName = createName( name, 0);
+
+			if (removeNode( list, pName, &ptr))
+			{
+				log_op( list, wal, WAL_REMOVE, name, 0);
+				fprintf( stdout, "(%s, %d) deleted\n", ptr->name, ptr->freq);
+				destroyName( ptr);
+			}
+			else fprintf( stdout, "%s not found\n", name);
+			
+			destroyName( pName);
+			break;
 		
-		if (action) fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
+		case COUNT:
+			fprintf( stdout, "%d\n", countList( list));
+			break;
 	}
-	return 0;
 }
 
+// returns monotonic clock in nanoseconds
+static long long now_ns( void){
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// for qsort function
+static int cmpLatency( const void *p1, const void *p2){
+	long long a = *(const long long *)p1;
+	long long b = *(const long long *)p2;
+	
+	return (a > b) - (a < b);
+}
+
+// appends latency of a command to the statistics
+//	return	0 if overflow
+//			1 if successful
+static int add_latency( tStat *stat, long long ns){
+	if (stat->len == stat->capacity){
+		int capacity = stat->capacity ? stat->capacity * 2 : 1024;
+		long long *latency = (long long *)realloc( stat->latency, sizeof(long long) * capacity);
+		if (!latency) return 0;
+		
+		stat->latency = latency;
+		stat->capacity = capacity;
+	}
+	stat->latency[stat->len++] = ns;
+	return 1;
+}
+
+// prints per-command counts, throughput and latency percentiles to stderr
+static void print_stat( tStat *stat, long long elapsed){
+	static const char *label[MAX_ACTION + 1] = { "?", "Q", "P", "B", "S", "D", "C", "A"};
+	double sec = elapsed / 1e9;
+	int i;
+	
+	fprintf( stderr, "commands: %d (", stat->len);
+	for (i = FORWARD_PRINT; i <= MAX_ACTION; i++)
+		fprintf( stderr, "%s%s %d", i == FORWARD_PRINT ? "" : ", ", label[i], stat->count[i]);
+	fprintf( stderr, ")\n");
+	if (stat->count[0]) fprintf( stderr, "skipped: %d undefined commands\n", stat->count[0]);
+	
+	fprintf( stderr, "elapsed: %.3f sec, throughput: %.0f ops/sec\n", sec, sec > 0 ? stat->len / sec : 0.0);
+	
+	if (stat->len == 0) return;
+	
+	qsort( stat->latency, stat->len, sizeof(long long), cmpLatency);
+	fprintf( stderr, "latency (us): p50 %.2f, p90 %.2f, p99 %.2f, p99.9 %.2f, max %.2f\n",
+		stat->latency[(int)(stat->len * 0.50)] / 1e3,
+		stat->latency[(int)(stat->len * 0.90)] / 1e3,
+		stat->latency[(int)(stat->len * 0.99)] / 1e3,
+		stat->latency[(int)(stat->len * 0.999)] / 1e3,
+		stat->latency[stat->len - 1] / 1e3);
+}
+
+// reads commands from script and executes them without prompts
+// a command per line: S name, A name freq, D name, C, P, B, Q
+// results are committed in chunks of GROUP_COMMIT commands, and before a
+// listing (P, B) whose output may fill the stdout buffer
+//	return	0 if overflow
+//			1 if successful
+int run_batch( LIST *list, WAL *wal, FILE *script){
+	char line[MAX_LINE];
+	char name[100];
+	char arg2[100];
+	tStat stat = { {0}, NULL, 0, 0};
+	long long start, t0;
+	int chunk = 0;
+	int ret = 1;
+	
+	// results go to a fully buffered stdout
+	setvbuf( stdout, NULL, _IOFBF, BATCH_BUFSIZE);
+	
+	start = now_ns();
+	while (fgets( line, MAX_LINE, script) != NULL){
+		char *p = line;
+		int action;
+		
+		while (isspace( (unsigned char)*p)) p++;
+		if (*p == '\0' || *p == '#') continue; // empty line or comment
+		
+		action = char_to_action( *p);
+		if (action == QUIT) break;
+		
+		if (!action || ((action == SEARCH || action == DELETE) && sscanf( p + 1, "%99s", name) != 1)
+			|| (action == ADD && sscanf( p + 1, "%99s %99s", name, arg2) != 2)){
+			stat.count[0]++;
+			continue;
+		}
+		
+		if (chunk == GROUP_COMMIT || action == FORWARD_PRINT || action == BACKWARD_PRINT){
+			commit_results( wal);
+			chunk = 0;
+		}
+		
+		t0 = now_ns();
+		run_action( list, wal, action, name, arg2);
+		if (!add_latency( &stat, now_ns() - t0)){
+			ret = 0;
+			break;
+		}
+		stat.count[action]++;
+		chunk++;
+	}
+	commit_results( wal);
+	
+	print_stat( &stat, now_ns() - start);
+	free( stat.latency);
+	
+	return ret;
+}
 
 // Allocates dynamic memory for a list head node and returns its address to caller
 // return	head node pointer
@@ -380,6 +755,8 @@ static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr){
 		if (pList->head != NULL) 
 			pList->head->llink = name;
 		pList->head = name;
+		if (pList->rear == NULL)
+			pList->rear = name;
 		
 		return 1;
 	}
@@ -406,18 +783,15 @@ static int _insert( LIST *pList, NODE *pPre, tName *dataInPtr){
 static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, tName **dataOutPtr){
 	*dataOutPtr = pLoc->dataPtr;
 	
-	if (pPre == NULL ){
-		pLoc->rlink->llink = NULL;
+	if (pPre == NULL )
 		pList->head = pLoc->rlink;
-	}
-	else if (pLoc->rlink == NULL){
-		pLoc->rlink->llink = NULL;
-		pList->rear = pPre;
-	}
-	else{
+	else
 		pPre->rlink = pLoc->rlink;
+	
+	if (pLoc->rlink == NULL)
+		pList->rear = pPre;
+	else
 		pLoc->rlink->llink = pPre;
-	}
 	
 	free(pLoc);
 }
@@ -441,6 +815,372 @@ static int _search( LIST *pList, NODE **pPre, NODE **pLoc, tName *pArgu){
 	return 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// internal function
+// return	prefix + suffix (caller frees)
+// 			NULL if overflow
+static char *_path( const char *prefix, const char *suffix){
+	char *path = (char *)malloc(strlen(prefix) + strlen(suffix) + 1);
+	if (path == NULL) return NULL;
+
+	strcpy(path, prefix);
+	strcat(path, suffix);
+	return path;
+}
+
+// internal function
+// writes a length-prefixed name and freq
+// return	1 success
+// 			0 I/O error
+static int _writeName( FILE *fp, const char *name, int freq){
+	size_t len = strlen(name);
+	unsigned short len16 = (unsigned short)len;
+
+	if (len > MAX_NAME) return 0;
+
+	return fwrite(&len16, sizeof(len16), 1, fp) == 1
+		&& fwrite(name, 1, len, fp) == len
+		&& fwrite(&freq, sizeof(freq), 1, fp) == 1;
+}
+
+// internal function
+// reads a length-prefixed name (name holds MAX_NAME + 1 chars) and freq
+// return	1 success
+// 			0 end of file or torn record
+static int _readName( FILE *fp, char *name, int *freq){
+	unsigned short len16;
+
+	if (fread(&len16, sizeof(len16), 1, fp) != 1) return 0;
+	if (fread(name, 1, len16, fp) != len16) return 0;
+	name[len16] = '\0';
+
+	return fread(freq, sizeof(*freq), 1, fp) == 1;
+}
+
+// internal function
+// flushes and syncs fp to disk
+static int _sync( FILE *fp){
+	if (fflush(fp) != 0) return 0;
+	return fsync(fileno(fp)) == 0;
+}
+
+// internal function
+// syncs the directory holding path, so a rename in it is on disk
+// return	1 success
+// 			0 I/O error
+static int _syncDir( const char *path){
+	const char *slash = strrchr(path, '/');
+	char *dir;
+	int fd, ok;
+
+	if (slash == NULL) dir = _path(".", "");
+	else if (slash == path) dir = _path("/", "");
+	else{
+		dir = _path(path, "");
+		if (dir != NULL) dir[slash - path] = '\0';
+	}
+	if (dir == NULL) return 0;
+
+	fd = open(dir, O_RDONLY);
+	free(dir);
+	if (fd < 0) return 0;
+
+	ok = fsync(fd) == 0;
+	close(fd);
+	return ok;
+}
+
+// internal function
+// reads the log records after lsn into an array and their names into one buffer
+// good is set to the end of the last whole record (a torn record is dropped)
+// return	number of records (caller frees *records and *names)
+// 			-1 if overflow
+static int _readTail( FILE *fp, unsigned long long lsn, LOGREC **records, char **names, long *good){
+	static char name[MAX_NAME + 1];
+	LOGREC *rec = NULL, *tmpRec;
+	char *buf = NULL, *tmpBuf;
+	size_t used = 0, size = 0, len;
+	int n = 0, capacity = 0, overflow = 0, i;
+
+	while (1){
+		unsigned long long recLsn;
+		unsigned char op;
+		int freq;
+
+		if (fread(&recLsn, sizeof(recLsn), 1, fp) != 1
+			|| fread(&op, 1, 1, fp) != 1
+			|| !_readName(fp, name, &freq))
+			break;
+		*good = ftell(fp);
+
+		if (recLsn <= lsn) continue; // already in checkpoint
+
+		len = strlen(name) + 1;
+		if (n == capacity){
+			capacity = capacity ? capacity * 2 : 1024;
+			tmpRec = (LOGREC *)realloc(rec, sizeof(LOGREC) * capacity);
+			if (tmpRec == NULL){
+				overflow = 1;
+				break;
+			}
+			rec = tmpRec;
+		}
+		if (used + len > size){
+			size = (used + len) * 2;
+			tmpBuf = (char *)realloc(buf, size);
+			if (tmpBuf == NULL){
+				overflow = 1;
+				break;
+			}
+			buf = tmpBuf;
+		}
+		memcpy(buf + used, name, len);
+		rec[n].lsn = recLsn;
+		rec[n].offset = used;
+		rec[n].freq = freq;
+		rec[n].op = op;
+		used += len;
+		n++;
+	}
+	if (overflow){
+		free(rec);
+		free(buf);
+		return -1;
+	}
+
+	for (i = 0; i < n; i++)
+		rec[i].name = buf + rec[i].offset;
+	*records = rec;
+	*names = buf;
+	return n;
+}
+
+// internal function
+// orders log records by name (strcmp, as the name list), then by lsn
+// for qsort function
+static int _cmpRecord( const void *p1, const void *p2){
+	const LOGREC *a = (const LOGREC *)p1;
+	const LOGREC *b = (const LOGREC *)p2;
+	int cmp = strcmp(a->name, b->name);
+
+	if (cmp != 0) return cmp;
+	return (a->lsn > b->lsn) - (a->lsn < b->lsn);
+}
+
+// Allocates WAL for files PREFIX.log and PREFIX.ckpt
+// return	WAL pointer
+// 			NULL if overflow
+WAL *wal_Open( const char *prefix, int groupCommit){
+	WAL *wal = (WAL *)malloc(sizeof(WAL));
+	if (wal == NULL) return NULL;
+
+	wal->log = NULL;
+	wal->ckpt = NULL;
+	wal->logPath = _path(prefix, ".log");
+	wal->ckptPath = _path(prefix, ".ckpt");
+	wal->tmpPath = _path(prefix, ".ckpt.tmp");
+	wal->lsn = 0;
+	wal->pending = 0;
+	wal->records = 0;
+	wal->groupCommit = groupCommit > 0 ? groupCommit : 1;
+	wal->checkpointAt = CHECKPOINT_INTERVAL;
+
+	if (!wal->logPath || !wal->ckptPath || !wal->tmpPath){
+		wal_Close(wal);
+		return NULL;
+	}
+	return wal;
+}
+
+// Syncs the log and recycles memory
+void wal_Close( WAL *wal){
+	if (wal->log != NULL){
+		_sync(wal->log);
+		fclose(wal->log);
+	}
+	if (wal->ckpt != NULL) fclose(wal->ckpt);
+
+	free(wal->logPath);
+	free(wal->ckptPath);
+	free(wal->tmpPath);
+	free(wal);
+}
+
+// return 1 if a checkpoint or log exists; 0 if not
+int wal_Exists( WAL *wal){
+	return access(wal->ckptPath, F_OK) == 0 || access(wal->logPath, F_OK) == 0;
+}
+
+// Loads the checkpoint (appended to list) and replays the log records after it
+// in name order (one merge pass over the list), then opens the log for appending
+// return	number of replayed log records
+// 			-1 if error
+int wal_Recover( WAL *wal, LIST *list){
+	static char name[MAX_NAME + 1];
+	unsigned long long lsn = 0;
+	unsigned int count, i;
+	char magic[4];
+	int freq;
+	int replayed = 0;
+	long good = 0;
+	tName *pName, *ptr;
+	NODE *pPre = NULL, *pLoc, *next;
+	LOGREC *records;
+	char *names;
+	FILE *fp;
+
+	// checkpoint (names are in list order)
+	if ((fp = fopen(wal->ckptPath, "rb")) != NULL){
+		setvbuf(fp, NULL, _IOFBF, IO_BUFSIZE);
+
+		if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, CKPT_MAGIC, 4) != 0
+			|| fread(&lsn, sizeof(lsn), 1, fp) != 1
+			|| fread(&count, sizeof(count), 1, fp) != 1){
+			fclose(fp);
+			return -1;
+		}
+		for (i = 0; i < count; i++){
+			if (!_readName(fp, name, &freq)
+				|| (pName = createName(name, freq)) == NULL
+				|| !_insert(list, list->rear, pName)){
+				fclose(fp);
+				return -1;
+			}
+			list->count++;
+		}
+		fclose(fp);
+	}
+	wal->lsn = lsn;
+
+	// log tail
+	if ((fp = fopen(wal->logPath, "rb")) != NULL){
+		setvbuf(fp, NULL, _IOFBF, IO_BUFSIZE);
+
+		replayed = _readTail(fp, wal->lsn, &records, &names, &good);
+		fclose(fp);
+		if (replayed < 0) return -1;
+
+		// operations on different names commute, so the tail is replayed in
+		// name order: one merge pass over the list instead of a search per record
+		if (replayed > 0) qsort(records, replayed, sizeof(LOGREC), _cmpRecord);
+		pLoc = list->head;
+		for (i = 0; i < (unsigned int)replayed; i++){
+			tName key = { (char *)records[i].name, records[i].freq};
+
+			while (pLoc != NULL && cmpName(pLoc->dataPtr, &key) < 0){
+				pPre = pLoc;
+				pLoc = pLoc->rlink;
+			}
+			if (records[i].lsn > wal->lsn) wal->lsn = records[i].lsn;
+			if (pLoc != NULL && cmpName(pLoc->dataPtr, &key) == 0){
+				if (records[i].op == WAL_ADD) increase_freq(pLoc->dataPtr, &key);
+				else{
+					next = pLoc->rlink;
+					_delete(list, pPre, pLoc, &ptr);
+					list->count--;
+					destroyName(ptr);
+					pLoc = next;
+				}
+			}
+			else if (records[i].op == WAL_ADD){
+				if ((pName = createName(key.name, key.freq)) == NULL || !_insert(list, pPre, pName)){
+					if (pName) destroyName(pName);
+					free(records);
+					free(names);
+					return -1;
+				}
+				list->count++;
+				pLoc = (pPre == NULL) ? list->head : pPre->rlink;
+			}
+		}
+		free(records);
+		free(names);
+
+		// drops a torn record at the end
+		if (truncate(wal->logPath, good) != 0) return -1;
+	}
+	wal->records = replayed;
+
+	wal->log = fopen(wal->logPath, "ab");
+	if (wal->log == NULL) return -1;
+
+	return replayed;
+}
+
+// Appends an operation (WAL_ADD or WAL_REMOVE) to the log
+// the log is synced every groupCommit records; callers sync (wal_Sync) before
+// they acknowledge the operation
+// return	1 success
+// 			0 I/O error
+int wal_Append( WAL *wal, int op, const char *name, int freq){
+	unsigned long long lsn = wal->lsn + 1;
+	unsigned char op8 = (unsigned char)op;
+
+	if (wal->log == NULL) return 0;
+
+	if (fwrite(&lsn, sizeof(lsn), 1, wal->log) != 1
+		|| fwrite(&op8, 1, 1, wal->log) != 1
+		|| !_writeName(wal->log, name, freq))
+		return 0;
+
+	wal->lsn = lsn;
+	wal->records++;
+
+	if (++wal->pending >= wal->groupCommit)
+		return wal_Sync(wal);
+	return 1;
+}
+
+// Flushes and syncs pending log records
+// return	1 success
+// 			0 I/O error
+int wal_Sync( WAL *wal){
+	if (wal->log == NULL || wal->pending == 0) return 1;
+
+	wal->pending = 0;
+	return _sync(wal->log);
+}
+
+// Writes all names in list order to a new checkpoint, then truncates the log
+// return	1 success
+// 			0 I/O error
+int wal_Checkpoint( WAL *wal, LIST *list){
+	unsigned int count32 = (unsigned int)list->count;
+	NODE *node;
+	int ok;
+
+	wal->ckpt = fopen(wal->tmpPath, "wb");
+	if (wal->ckpt == NULL) return 0;
+	setvbuf(wal->ckpt, NULL, _IOFBF, IO_BUFSIZE);
+
+	ok = fwrite(CKPT_MAGIC, 1, 4, wal->ckpt) == 4
+		&& fwrite(&wal->lsn, sizeof(wal->lsn), 1, wal->ckpt) == 1
+		&& fwrite(&count32, sizeof(count32), 1, wal->ckpt) == 1;
+
+	for (node = list->head; ok && node != NULL; node = node->rlink)
+		ok = _writeName(wal->ckpt, node->dataPtr->name, node->dataPtr->freq);
+
+	ok = ok && _sync(wal->ckpt);
+	ok = fclose(wal->ckpt) == 0 && ok;
+	wal->ckpt = NULL;
+	if (!ok || rename(wal->tmpPath, wal->ckptPath) != 0){
+		remove(wal->tmpPath); // the checkpoint is abandoned
+		return 0;
+	}
+
+	// the rename must be on disk before the log is truncated
+	if (!_syncDir(wal->ckptPath)) return 0;
+
+	// records up to lsn are in the checkpoint now
+	if (wal->log != NULL) fclose(wal->log);
+	wal->log = fopen(wal->logPath, "wb");
+	if (wal->log == NULL) return 0;
+
+	wal->pending = 0;
+	wal->records = 0;
+	return 1;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Allocates dynamic memory for a name structure, initialize fields(name, freq) and returns its address to caller
 //	return	name structure pointer
@@ -0,0 +1,237 @@
+#include <stdlib.h> // malloc
+
+#include "adt_cdlist.h"
+
+// link and marked are shared with lock-free readers
+#define LOAD(ptr)			__atomic_load_n( &(ptr), __ATOMIC_ACQUIRE)
+#define STORE(ptr, val)		__atomic_store_n( &(ptr), (val), __ATOMIC_RELEASE)
+
+// internal node allocation
+// return	node pointer
+// 			NULL if overflow
+static CNODE *_makeNode( void *dataPtr, int sentinel){
+	CNODE *node = (CNODE *)malloc(sizeof(CNODE));
+	if (!node) return NULL;
+
+	node->dataPtr = dataPtr;
+	node->link = NULL;
+	node->retired = NULL;
+	node->marked = 0;
+	node->sentinel = sentinel;
+	pthread_mutex_init( &node->lock, NULL);
+
+	return node;
+}
+
+static void _freeNode( CNODE *node){
+	pthread_mutex_destroy( &node->lock);
+	free( node);
+}
+
+// internal compare function
+// compares key with node (sentinels are smaller/larger than any key)
+static int _compare( CLIST *pList, void *pArgu, CNODE *node){
+	if (node->sentinel) return -node->sentinel;
+	return pList->compare( pArgu, node->dataPtr);
+}
+
+// internal search function (no lock)
+// passes back the first node not smaller than key and its predecessor
+// return	1 found
+// 			0 not found
+static int _search( CLIST *pList, CNODE **pPre, CNODE **pLoc, void *pArgu){
+	CNODE *pre = pList->head;
+	CNODE *loc = LOAD(pre->link);
+	int flag;
+
+	while ((flag = _compare( pList, pArgu, loc)) > 0){
+		pre = loc;
+		loc = LOAD(loc->link);
+	}
+
+	*pPre = pre;
+	*pLoc = loc;
+	return !flag;
+}
+
+// internal validate function (pPre and pLoc are locked)
+// return	1 if pPre and pLoc are still adjacent and not deleted
+// 			0 if search must be retried
+static int _validate( CNODE *pPre, CNODE *pLoc){
+	return !pPre->marked && !pLoc->marked && pPre->link == pLoc;
+}
+
+static void _lock( CNODE *pPre, CNODE *pLoc){
+	pthread_mutex_lock( &pPre->lock);
+	pthread_mutex_lock( &pLoc->lock);
+}
+
+static void _unlock( CNODE *pPre, CNODE *pLoc){
+	pthread_mutex_unlock( &pLoc->lock);
+	pthread_mutex_unlock( &pPre->lock);
+}
+
+// Allocates dynamic memory for a list head node and returns its address to caller
+// return	head node pointer
+// 			NULL if overflow
+CLIST *createCList( int (*compare)(const void *, const void *)){
+	CLIST *pList = (CLIST *)malloc( sizeof(CLIST));
+	if (!pList) return NULL;
+
+	pList->head = _makeNode( NULL, -1);
+	pList->tail = _makeNode( NULL, 1);
+	if (!pList->head || !pList->tail){
+		free( pList->head);
+		free( pList->tail);
+		free( pList);
+		return NULL;
+	}
+	pList->head->link = pList->tail;
+
+	pList->count = 0;
+	pList->retired = NULL;
+	pthread_mutex_init( &pList->retiredLock, NULL);
+	pList->compare = compare;
+
+	return pList;
+}
+
+// Recycles memory of list, nodes and data (must not be called concurrently)
+void destroyCList( CLIST *pList, void (*callback)(void *)){
+	CNODE *node = pList->head->link;
+	CNODE *next;
+
+	while (node != pList->tail){
+		next = node->link;
+		(*callback)(node->dataPtr);
+		_freeNode( node);
+		node = next;
+	}
+
+	reclaimCList( pList);
+	_freeNode( pList->head);
+	_freeNode( pList->tail);
+	pthread_mutex_destroy( &pList->retiredLock);
+	free( pList);
+}
+
+// Inserts data into list
+// callback is called with pLoc locked if the key is duplicated
+//	return	0 if overflow
+//			1 if successful
+//			2 if duplicated key
+int addCNode( CLIST *pList, void *dataInPtr, void (*callback)(const void *, const void *)){
+	CNODE *pPre, *pLoc, *node;
+	int found;
+
+	while (1){
+		found = _search( pList, &pPre, &pLoc, dataInPtr);
+
+		_lock( pPre, pLoc);
+		if (_validate( pPre, pLoc)) break;
+		_unlock( pPre, pLoc);
+	}
+
+	if (found){
+		(*callback)(pLoc->dataPtr, dataInPtr);
+		_unlock( pPre, pLoc);
+		return 2;
+	}
+
+	node = _makeNode( dataInPtr, 0);
+	if (!node){
+		_unlock( pPre, pLoc);
+		return 0;
+	}
+	node->link = pLoc;
+	STORE(pPre->link, node); // publishes node to readers
+	__atomic_add_fetch( &pList->count, 1, __ATOMIC_RELAXED);
+
+	_unlock( pPre, pLoc);
+	return 1;
+}
+
+// Removes data from list
+//	return	0 not found
+//			1 deleted
+int removeCNode( CLIST *pList, void *keyPtr, void **dataOutPtr){
+	CNODE *pPre, *pLoc;
+	int found;
+
+	while (1){
+		found = _search( pList, &pPre, &pLoc, keyPtr);
+
+		_lock( pPre, pLoc);
+		if (_validate( pPre, pLoc)) break;
+		_unlock( pPre, pLoc);
+	}
+
+	if (!found){
+		_unlock( pPre, pLoc);
+		return 0;
+	}
+
+	*dataOutPtr = pLoc->dataPtr;
+	STORE(pLoc->marked, 1); // logical delete
+	STORE(pPre->link, pLoc->link); // physical delete
+	__atomic_sub_fetch( &pList->count, 1, __ATOMIC_RELAXED);
+	_unlock( pPre, pLoc);
+
+	pthread_mutex_lock( &pList->retiredLock);
+	pLoc->retired = pList->retired;
+	pList->retired = pLoc;
+	pthread_mutex_unlock( &pList->retiredLock);
+
+	return 1;
+}
+
+// Searches list without locking
+//	pArgu	key being sought
+//	dataOutPtr	contains found data
+//	return	1 successful
+//			0 not found
+int searchCList( CLIST *pList, void *pArgu, void **dataOutPtr){
+	CNODE *pPre, *pLoc;
+
+	if (_search( pList, &pPre, &pLoc, pArgu) && !LOAD(pLoc->marked)){
+		*dataOutPtr = pLoc->dataPtr;
+		return 1;
+	}
+	return 0;
+}
+
+// returns number of nodes in list
+int countCList( CLIST *pList){
+	return __atomic_load_n( &pList->count, __ATOMIC_RELAXED);
+}
+
+// returns	1 empty
+//			0 list has data
+int emptyCList( CLIST *pList){
+	return !countCList( pList) ? 1 : 0;
+}
+
+// traverses data from list (forward)
+// concurrent updates may or may not be seen
+void traverseCList( CLIST *pList, void (*callback)(const void *)){
+	CNODE *node = LOAD(pList->head->link);
+
+	while (node != pList->tail){
+		if (!LOAD(node->marked))
+			(*callback)(node->dataPtr);
+		node = LOAD(node->link);
+	}
+}
+
+// Recycles nodes removed so far (must not be called concurrently)
+void reclaimCList( CLIST *pList){
+	CNODE *node = pList->retired;
+	CNODE *next;
+
+	while (node != NULL){
+		next = node->retired;
+		_freeNode( node);
+		node = next;
+	}
+	pList->retired = NULL;
+}
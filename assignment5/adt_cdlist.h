@@ -0,0 +1,83 @@
+#include <pthread.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Concurrent ordered list (lazy synchronization)
+//
+// searchCList takes no lock and never retries (wait-free).
+// addCNode and removeCNode lock only the two neighbouring nodes (pPre, pLoc)
+// and validate them after locking; removal marks the node first (logical
+// delete) and unlinks it afterwards (physical delete).
+// Removed nodes may still be read by concurrent searches, so they are kept
+// on a retired list and recycled by reclaimCList or destroyCList.
+// There is no epoch or hazard-pointer reclamation: memory grows with every
+// removal until the caller reaches a quiescent point (no thread in any list
+// call) and calls reclaimCList there. A workload that never pauses must
+// schedule such points itself, or its memory is unbounded.
+// The list is singly linked: there is no backward traversal.
+
+////////////////////////////////////////////////////////////////////////////////
+// CLIST type definition
+typedef struct cnode
+{
+	void			*dataPtr;
+	struct cnode	*link;		// next node (read without lock)
+	struct cnode	*retired;	// next node in retired list
+	int				marked;		// 1 if logically deleted
+	int				sentinel;	// -1 head, 1 tail, 0 data node
+	pthread_mutex_t	lock;
+} CNODE;
+
+typedef struct
+{
+	int				count;
+	CNODE			*head;		// sentinel (smaller than any key)
+	CNODE			*tail;		// sentinel (larger than any key)
+	CNODE			*retired;	// removed nodes waiting to be recycled
+	pthread_mutex_t	retiredLock;
+	int				(*compare)(const void *, const void *);
+} CLIST;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// Allocates dynamic memory for a list head node and returns its address to caller
+// return	head node pointer
+// 			NULL if overflow
+CLIST *createCList( int (*compare)(const void *, const void *));
+
+// Recycles memory of list, nodes and data (must not be called concurrently)
+void destroyCList( CLIST *pList, void (*callback)(void *));
+
+// Inserts data into list
+// callback is called with pLoc locked if the key is duplicated
+//	return	0 if overflow
+//			1 if successful
+//			2 if duplicated key
+int addCNode( CLIST *pList, void *dataInPtr, void (*callback)(const void *, const void *));
+
+// Removes data from list
+//	return	0 not found
+//			1 deleted
+int removeCNode( CLIST *pList, void *keyPtr, void **dataOutPtr);
+
+// Searches list without locking
+//	pArgu	key being sought
+//	dataOutPtr	contains found data
+//	return	1 successful
+//			0 not found
+int searchCList( CLIST *pList, void *pArgu, void **dataOutPtr);
+
+// returns number of nodes in list
+int countCList( CLIST *pList);
+
+// returns	1 empty
+//			0 list has data
+int emptyCList( CLIST *pList);
+
+// traverses data from list (forward)
+// concurrent updates may or may not be seen
+void traverseCList( CLIST *pList, void (*callback)(const void *));
+
+// Recycles nodes removed so far (must not be called concurrently)
+// the only bound on retired memory: call it whenever no thread uses the list
+void reclaimCList( CLIST *pList);
@@ -2,75 +2,68 @@
 
 #include "adt_dlist.h"
 
+// internal link function
+// links an allocated node into list after pPre (the sentinel for head)
+static void _link( LIST *pList, NODE *pPre, NODE *name){
+	name->llink = pPre;
+	name->rlink = pPre->rlink;
+	pPre->rlink->llink = name;
+	pPre->rlink = name;
+	
+	pList->count++;
+}
+
 // internal insert function
-// inserts data into list
+// inserts data into list after pPre
 // return	1 if successful
 // 			0 if memory overflow
 static int _insert( LIST *pList, NODE *pPre, void *dataInPtr){	
 	NODE *name = (NODE *)malloc(sizeof(NODE));
 	if (!name) return 0;	
 	name->dataPtr = dataInPtr;
+	name->hits = 0;
 	
-	if (pPre == NULL ){
-		name->llink = NULL;
-		name->rlink = pList->head;
-		
-		if (pList->head != NULL) 
-			pList->head->llink = name;
-		pList->head = name;
-		
-		return 1;
-	}
-	
-	name->llink = pPre;
-	
-	if (pPre->rlink == NULL){
-		name->rlink = NULL;
-		pList->rear = name;
-		
-	}
-	else{
-		name->rlink = pPre->rlink;
-		pPre->rlink->llink = name;
-	}
-	
-	pPre->rlink = name;
-	
+	_link( pList, pPre, name);
 	return 1;
 }
 
+// internal unlink function
+// unlinks pLoc from list without freeing it
+static void _unlink( LIST *pList, NODE *pLoc){
+	pLoc->llink->rlink = pLoc->rlink;
+	pLoc->rlink->llink = pLoc->llink;
+	
+	pList->count--;
+}
+
 // internal delete function
 // deletes data from list and saves the (deleted) data to dataOutPtr
-static void _delete( LIST *pList, NODE *pPre, NODE *pLoc, void **dataOutPtr){
+static void _delete( LIST *pList, NODE *pLoc, void **dataOutPtr){
 	*dataOutPtr = pLoc->dataPtr;
 	
-	if (pPre == NULL ){
-		pLoc->rlink->llink = NULL;
-		pList->head = pLoc->rlink;
-	}
-	else if (pLoc->rlink == NULL){
-		pLoc->rlink->llink = NULL;
-		pList->rear = pPre;
-	}
-	else{
-		pPre->rlink = pLoc->rlink;
-		pLoc->rlink->llink = pPre;
-	}
-	
+	_unlink( pList, pLoc);
 	free(pLoc);
 }
 
 
 // internal search function
-// searches list and passes back address of node containing target and its logical predecessor
+// searches list from the head and passes back address of node containing target
+// and its logical predecessor (the sentinel if none)
+// (in self-organizing modes, pPre becomes the rear if not found)
 // return	1 found
 // 			0 not found
 static int _search( LIST *pList, NODE **pPre, NODE **pLoc, void *pArgu){
 	int flag = 0;
 	
-	while(*pLoc != NULL){
-		if (!(pList->compare(pArgu, (*pLoc)->dataPtr))) return 1;
-		else if ((pList->compare(pArgu, (*pLoc)->dataPtr)) < 0) return 0;
+	*pPre = &pList->sentinel;
+	*pLoc = pList->sentinel.rlink;
+	
+	while(*pLoc != &pList->sentinel){
+		pList->probes++;
+		flag = pList->compare(pArgu, (*pLoc)->dataPtr);
+		
+		if (!flag) return 1;
+		else if (flag < 0 && pList->mode == LIST_ORDERED) return 0;
 		
 		*pPre = *pLoc;
 		*pLoc = (*pLoc)->rlink;
@@ -79,34 +72,156 @@ static int _search( LIST *pList, NODE **pPre, NODE **pLoc, void *pArgu){
 	return 0;
 }
 
+// internal reorganize function
+// moves found node pLoc toward head according to the self-organizing mode
+static void _reorganize( LIST *pList, NODE *pLoc){
+	NODE *sentinel = &pList->sentinel;
+	NODE *pPre = pLoc->llink;
+	
+	switch (pList->mode){
+		case LIST_MOVE_TO_FRONT:
+			if (pPre == sentinel) return;
+			_unlink( pList, pLoc);
+			_link( pList, sentinel, pLoc);
+			break;
+		
+		case LIST_TRANSPOSE:
+			if (pPre == sentinel) return;
+			_unlink( pList, pLoc);
+			_link( pList, pPre->llink, pLoc);
+			break;
+		
+		case LIST_FREQ_COUNT:
+			pLoc->hits++;
+			if (pPre == sentinel || pPre->hits >= pLoc->hits) return;
+			
+			_unlink( pList, pLoc);
+			while (pPre != sentinel && pPre->hits < pLoc->hits)
+				pPre = pPre->llink;
+			_link( pList, pPre, pLoc);
+			break;
+	}
+}
+
+// internal merge sort function
+// sorts data array with compare (tmp must hold n pointers)
+static void _sortData( void **data, void **tmp, int n, int (*compare)(const void *, const void *)){
+	int mid = n / 2;
+	int i = 0, j = mid, k = 0;
+	
+	if (n < 2) return;
+	
+	_sortData( data, tmp, mid, compare);
+	_sortData( data + mid, tmp, n - mid, compare);
+	
+	while (i < mid && j < n){
+		if (compare(data[j], data[i]) < 0) tmp[k++] = data[j++];
+		else tmp[k++] = data[i++];
+	}
+	while (i < mid) tmp[k++] = data[i++];
+	while (j < n) tmp[k++] = data[j++];
+	
+	for (k = 0; k < n; k++) data[k] = tmp[k];
+}
+
+// internal snapshot function
+// return	array of data pointers sorted by compare (caller frees it)
+//			NULL if overflow or empty
+static void **_sortedSnapshot( LIST *pList){
+	void **data, **tmp;
+	NODE *node;
+	int n = 0;
+	
+	if (pList->count == 0) return NULL;
+	
+	data = (void **)malloc(sizeof(void *) * pList->count);
+	tmp = (void **)malloc(sizeof(void *) * pList->count);
+	if (!data || !tmp){
+		free(data);
+		free(tmp);
+		return NULL;
+	}
+	
+	for (node = pList->sentinel.rlink; node != &pList->sentinel; node = node->rlink)
+		data[n++] = node->dataPtr;
+	
+	_sortData( data, tmp, n, pList->compare);
+	free(tmp);
+	
+	return data;
+}
+
+
+// internal filter function
+// walks two ordered lists together and removes data of pList whose key is
+// (keepCommon = 0) or is not (keepCommon = 1) in pOther
+// return	number of removed data
+static int _filterSorted( LIST *pList, LIST *pOther, int keepCommon, void (*callback)(void *)){
+	NODE *pa = pList->sentinel.rlink;
+	NODE *pb = pOther->sentinel.rlink;
+	NODE *next;
+	void *dataOutPtr;
+	int flag = 1;
+	int removed = 0;
+	
+	while (pa != &pList->sentinel){
+		while (pb != &pOther->sentinel && (flag = pList->compare(pb->dataPtr, pa->dataPtr)) < 0)
+			pb = pb->rlink;
+		
+		next = pa->rlink;
+		if ((pb != &pOther->sentinel && flag == 0) != keepCommon){
+			_delete( pList, pa, &dataOutPtr);
+			(*callback)(dataOutPtr);
+			removed++;
+		}
+		pa = next;
+	}
+	
+	return removed;
+}
 
 // Allocates dynamic memory for a list head node and returns its address to caller
 // return	head node pointer
 // 			NULL if overflow
 LIST *createList( int (*compare)(const void *, const void *)){
-	LIST *names = (LIST *)malloc( sizeof(LIST));
+	return createListMode( compare, LIST_ORDERED);
+}
+
+// Allocates a list head node with a list mode (LIST_ORDERED, LIST_MOVE_TO_FRONT, ...)
+// return	head node pointer
+// 			NULL if overflow or unknown mode
+LIST *createListMode( int (*compare)(const void *, const void *), int mode){
+	LIST *names;
+	
+	if (mode < LIST_ORDERED || mode > LIST_FREQ_COUNT) return NULL;
+	
+	names = (LIST *)malloc( sizeof(LIST));
 	if (!names) return NULL;
 	
 	names->count = 0;
-	names->head = NULL;
-	names->rear = NULL;
+	names->sentinel.dataPtr = NULL;
+	names->sentinel.llink = &names->sentinel;
+	names->sentinel.rlink = &names->sentinel;
+	names->sentinel.hits = 0;
 	names->compare = compare;
+	names->mode = mode;
+	names->probes = 0;
 
 	return names;
 }
 
 //  이름 리스트에 할당된 메모리를 해제 (head node, data node, name data)
 void destroyList( LIST *pList, void (*callback)(void *)){
-	NODE *ptr = NULL;
+	NODE *ptr = pList->sentinel.rlink;
+	NODE *next;
 	
-	while (pList->head != NULL){
-		ptr = pList->head;
-		pList->head = ptr->rlink;
+	while (ptr != &pList->sentinel){
+		next = ptr->rlink;
 		(*callback)(ptr->dataPtr);
 		free(ptr);
+		ptr = next;
 	}	
 	
-	pList->count = 0;
 	free(pList);
 }
 
@@ -115,34 +230,58 @@ void destroyList( LIST *pList, void (*callback)(void *)){
 //			1 if successful
 //			2 if duplicated key
 int addNode( LIST *pList, void *dataInPtr, void (*callback)(const void *, const void *)){
-	NODE *pPre = NULL;
-	NODE *pLoc = pList->head;
+	NODE *pPre, *pLoc;
 	
-	if (!_search(pList, &pPre, &pLoc, dataInPtr)){
-		if (!_insert( pList, pPre, dataInPtr))
-			return 0;
-		
-		if (pPre == NULL) pLoc = pList->head;
-		else pLoc = pPre->rlink;
-		
-		pList->count++;
-		return 1;
-	}
+	if (!_search(pList, &pPre, &pLoc, dataInPtr))
+		return _insert( pList, pPre, dataInPtr);
 	
 	(*callback)(pLoc->dataPtr, dataInPtr);
+	_reorganize( pList, pLoc);
 	return 2;
 }
 
+// Inserts data made from keyPtr into list, or merges keyPtr into the existing data
+//	keyPtr		borrowed key; it is never stored in list
+//	construct	makes data to store from keyPtr; called only if the key is absent
+//	callback	merges keyPtr into the existing data; called only if the key is present
+//	dataOutPtr	contains the inserted or merged data (if not NULL)
+//	return	0 if overflow
+//			1 if successful
+//			2 if duplicated key
+int upsertNode( LIST *pList, void *keyPtr, void *(*construct)(const void *), void (*callback)(const void *, const void *), void **dataOutPtr){
+	NODE *pPre, *pLoc;
+	NODE *name;
+	
+	if (_search(pList, &pPre, &pLoc, keyPtr)){
+		(*callback)(pLoc->dataPtr, keyPtr);
+		if (dataOutPtr) *dataOutPtr = pLoc->dataPtr;
+		_reorganize( pList, pLoc);
+		return 2;
+	}
+	
+	name = (NODE *)malloc(sizeof(NODE));
+	if (!name) return 0;
+	
+	name->dataPtr = (*construct)(keyPtr);
+	if (!name->dataPtr){
+		free(name);
+		return 0;
+	}
+	name->hits = 0;
+	
+	_link( pList, pPre, name);
+	if (dataOutPtr) *dataOutPtr = name->dataPtr;
+	return 1;
+}
+
 // Removes data from list
 //	return	0 not found
 //			1 deleted
 int removeNode( LIST *pList, void *keyPtr, void **dataOutPtr){
-	NODE *pPre = NULL;
-	NODE *pLoc = pList->head;
+	NODE *pPre, *pLoc;
 	
 	if (_search(pList, &pPre, &pLoc, keyPtr)){
-		_delete(pList, pPre, pLoc, dataOutPtr);
-		pList->count--;
+		_delete(pList, pLoc, dataOutPtr);
 		return 1;
 	}
 	return 0;
@@ -154,11 +293,11 @@ int removeNode( LIST *pList, void *keyPtr, void **dataOutPtr){
 //	return	1 successful
 //			0 not found
 int searchList( LIST *pList, void *pArgu, void **dataOutPtr){
-	NODE *pPre = NULL;
-	NODE *pLoc = pList->head;
+	NODE *pPre, *pLoc;
 	
 	if (_search(pList, &pPre, &pLoc, pArgu)){
 		*dataOutPtr = pLoc->dataPtr;
+		_reorganize( pList, pLoc);
 		return 1;
 	}
 	return 0;
@@ -176,21 +315,257 @@ int emptyList( LIST *pList){
 }
 
 // traverses data from list (forward)
-void traverseList( LIST *pList, void (*callback)(const void *)){
-	NODE *node = pList->head;
+// in key order even for self-organizing modes
+//	return	0 if overflow (nothing is traversed)
+//			1 if successful
+int traverseList( LIST *pList, void (*callback)(const void *)){
+	NODE *node = pList->sentinel.rlink;
+	
+	if (pList->mode != LIST_ORDERED){
+		void **data = _sortedSnapshot( pList);
+		int i;
+		
+		if (!data) return pList->count == 0;
+		for (i = 0; i < pList->count; i++)
+			(*callback)(data[i]);
+		free(data);
+		return 1;
+	}
 	
-	while(node != NULL){
+	while(node != &pList->sentinel){
 		(*callback)(node->dataPtr);
 		node = node->rlink;
 	}
+	return 1;
 }
 
 // traverses data from list (backward)
-void traverseListR( LIST *pList, void (*callback)(const void *)){
-	NODE *node = pList->rear;
+// in key order even for self-organizing modes
+//	return	0 if overflow (nothing is traversed)
+//			1 if successful
+int traverseListR( LIST *pList, void (*callback)(const void *)){
+	NODE *node = pList->sentinel.llink;
 	
-	while(node != NULL){
+	if (pList->mode != LIST_ORDERED){
+		void **data = _sortedSnapshot( pList);
+		int i;
+		
+		if (!data) return pList->count == 0;
+		for (i = pList->count - 1; i >= 0; i--)
+			(*callback)(data[i]);
+		free(data);
+		return 1;
+	}
+	
+	while(node != &pList->sentinel){
 		(*callback)(node->dataPtr);
 		node = node->llink;
 	}
-}
\ No newline at end of file
+	return 1;
+}
+
+// returns the first position (endList if list is empty)
+NODE *beginList( LIST *pList){
+	return pList->sentinel.rlink;
+}
+
+// returns the position past the rear
+NODE *endList( LIST *pList){
+	return &pList->sentinel;
+}
+
+// returns the next position (endList after the rear)
+NODE *nextNode( LIST *pList, NODE *pos){
+	return pos->rlink;
+}
+
+// returns the previous position (the rear for endList)
+NODE *prevNode( LIST *pList, NODE *pos){
+	return pos->llink;
+}
+
+// returns data at pos (pos must not be endList)
+void *dataAt( NODE *pos){
+	return pos->dataPtr;
+}
+
+// Removes data at pos and saves it to dataOutPtr
+//	return	the position following pos
+NODE *eraseAt( LIST *pList, NODE *pos, void **dataOutPtr){
+	NODE *next = pos->rlink;
+	
+	_delete( pList, pos, dataOutPtr);
+	return next;
+}
+
+// Inserts data before pos (at the rear for endList) without searching
+// caller must keep the list ordered
+//	return	position of the inserted data
+//			NULL if overflow
+NODE *insertBefore( LIST *pList, NODE *pos, void *dataInPtr){
+	if (!_insert( pList, pos->llink, dataInPtr))
+		return NULL;
+	
+	return pos->llink;
+}
+
+// Removes all data for which pred returns nonzero in one pass
+// removed data is passed to callback
+//	return	number of removed data
+int removeIf( LIST *pList, int (*pred)(const void *), void (*callback)(void *)){
+	NODE *pos = pList->sentinel.rlink;
+	void *dataOutPtr;
+	int removed = 0;
+	
+	while (pos != &pList->sentinel){
+		if ((*pred)(pos->dataPtr)){
+			pos = eraseAt( pList, pos, &dataOutPtr);
+			(*callback)(dataOutPtr);
+			removed++;
+		}
+		else pos = pos->rlink;
+	}
+	
+	return removed;
+}
+
+// Inserts data at the head
+//	return	0 if overflow
+//			1 if successful
+int pushFront( LIST *pList, void *dataInPtr){
+	return _insert( pList, &pList->sentinel, dataInPtr);
+}
+
+// Inserts data at the rear
+//	return	0 if overflow
+//			1 if successful
+int pushBack( LIST *pList, void *dataInPtr){
+	return _insert( pList, pList->sentinel.llink, dataInPtr);
+}
+
+// Removes data at the head and saves it to dataOutPtr
+//	return	0 if list is empty
+//			1 if successful
+int popFront( LIST *pList, void **dataOutPtr){
+	if (!pList->count) return 0;
+	
+	_delete( pList, pList->sentinel.rlink, dataOutPtr);
+	return 1;
+}
+
+// Removes data at the rear and saves it to dataOutPtr
+//	return	0 if list is empty
+//			1 if successful
+int popBack( LIST *pList, void **dataOutPtr){
+	if (!pList->count) return 0;
+	
+	_delete( pList, pList->sentinel.llink, dataOutPtr);
+	return 1;
+}
+
+// Moves all nodes of pOther before pos of pList in O(1); pOther becomes empty
+// caller must keep a LIST_ORDERED list ordered
+void spliceList( LIST *pList, NODE *pos, LIST *pOther){
+	NODE *first = pOther->sentinel.rlink;
+	NODE *last = pOther->sentinel.llink;
+	
+	if (!pOther->count) return;
+	
+	first->llink = pos->llink;
+	last->rlink = pos;
+	pos->llink->rlink = first;
+	pos->llink = last;
+	
+	pList->count += pOther->count;
+	
+	pOther->sentinel.llink = &pOther->sentinel;
+	pOther->sentinel.rlink = &pOther->sentinel;
+	pOther->count = 0;
+}
+
+// Moves all data of pOther into pList in order (sorted union)
+// for a key in both lists, callback merges pOther's data into pList's data
+// and pOther keeps that data (so caller can destroy pOther afterwards)
+//	return	number of duplicated keys
+//			-1 if a list is not LIST_ORDERED
+int mergeLists( LIST *pList, LIST *pOther, void (*callback)(const void *, const void *)){
+	NODE *pa = pList->sentinel.rlink;
+	NODE *pb = pOther->sentinel.rlink;
+	NODE *next;
+	int flag = 1;
+	int merged = 0;
+	
+	if (pList->mode != LIST_ORDERED || pOther->mode != LIST_ORDERED) return -1;
+	
+	while (pb != &pOther->sentinel){
+		while (pa != &pList->sentinel && (flag = pList->compare(pa->dataPtr, pb->dataPtr)) < 0)
+			pa = pa->rlink;
+		
+		next = pb->rlink;
+		if (pa != &pList->sentinel && flag == 0){
+			(*callback)(pa->dataPtr, pb->dataPtr);
+			merged++;
+			pa = pa->rlink;
+		}
+		else{
+			_unlink( pOther, pb);
+			_link( pList, pa->llink, pb);
+		}
+		pb = next;
+	}
+	
+	return merged;
+}
+
+// Moves data not less than keyPtr into a new list
+//	return	list of data not less than keyPtr
+//			NULL if overflow or pList is not LIST_ORDERED
+LIST *splitList( LIST *pList, void *keyPtr){
+	NODE *pos = pList->sentinel.rlink;
+	LIST *pNew;
+	int kept = 0;
+	
+	if (pList->mode != LIST_ORDERED) return NULL;
+	
+	pNew = createListMode( pList->compare, LIST_ORDERED);
+	if (!pNew) return NULL;
+	
+	while (pos != &pList->sentinel && pList->compare(pos->dataPtr, keyPtr) < 0){
+		pos = pos->rlink;
+		kept++;
+	}
+	if (pos == &pList->sentinel) return pNew;
+	
+	// cuts [pos, rear] out of pList
+	pNew->sentinel.rlink = pos;
+	pNew->sentinel.llink = pList->sentinel.llink;
+	pNew->sentinel.llink->rlink = &pNew->sentinel;
+	pNew->count = pList->count - kept;
+	
+	pList->sentinel.llink = pos->llink;
+	pos->llink->rlink = &pList->sentinel;
+	pos->llink = &pNew->sentinel;
+	pList->count = kept;
+	
+	return pNew;
+}
+
+// Removes data of pList whose key is not in pOther (pList becomes the intersection)
+// removed data is passed to callback; pOther is not changed
+//	return	number of removed data
+//			-1 if a list is not LIST_ORDERED
+int intersectLists( LIST *pList, LIST *pOther, void (*callback)(void *)){
+	if (pList->mode != LIST_ORDERED || pOther->mode != LIST_ORDERED) return -1;
+	
+	return _filterSorted( pList, pOther, 1, callback);
+}
+
+// Removes data of pList whose key is in pOther (pList becomes the difference)
+// removed data is passed to callback; pOther is not changed
+//	return	number of removed data
+//			-1 if a list is not LIST_ORDERED
+int differenceLists( LIST *pList, LIST *pOther, void (*callback)(void *)){
+	if (pList->mode != LIST_ORDERED || pOther->mode != LIST_ORDERED) return -1;
+	
+	return _filterSorted( pList, pOther, 0, callback);
+}
@@ -1,19 +1,32 @@
 
+////////////////////////////////////////////////////////////////////////////////
+// list modes (createListMode)
+#define LIST_ORDERED		0	// ordered by compare
+#define LIST_MOVE_TO_FRONT	1	// unordered; found data moves to head
+#define LIST_TRANSPOSE		2	// unordered; found data moves one step toward head
+#define LIST_FREQ_COUNT		3	// unordered; kept in descending order of access count
+
 ////////////////////////////////////////////////////////////////////////////////
 // LIST type definition
+// nodes form a circle through one sentinel node embedded in the list head:
+// sentinel.rlink is the first node, sentinel.llink the rear, and an empty list
+// has the sentinel linked to itself, so links and unlinks never branch
 typedef struct node
 {
 	void		*dataPtr;
 	struct node	*llink;
 	struct node	*rlink;
+	int			hits;	// access count (LIST_FREQ_COUNT); every mode pays for it:
+						// 8 more bytes per node on LP64 (padding), 24 -> 32
 } NODE;
 
 typedef struct
 {
-	int		count;
-	NODE	*head;
-	NODE	*rear;
-	int		(*compare)(const void *, const void *); // used in _search function
+	int			count;
+	NODE		sentinel;	// no data; the position past the rear
+	int			(*compare)(const void *, const void *); // used in _search function
+	int			mode;	// LIST_ORDERED or a self-organizing mode
+	long long	probes;	// number of nodes compared by searches
 } LIST;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -24,6 +37,13 @@ typedef struct
 // 			NULL if overflow
 LIST *createList( int (*compare)(const void *, const void *));
 
+// Allocates a list head node with a list mode (LIST_ORDERED, LIST_MOVE_TO_FRONT, ...)
+// self-organizing modes keep data unordered, insert at the rear and reorder
+// on every successful search; traverseList/traverseListR sort a snapshot
+// return	head node pointer
+// 			NULL if overflow or unknown mode
+LIST *createListMode( int (*compare)(const void *, const void *), int mode);
+
 //  이름 리스트에 할당된 메모리를 해제 (head node, data node, name data)
 void destroyList( LIST *pList, void (*callback)(void *));
 
@@ -33,6 +53,17 @@ void destroyList( LIST *pList, void (*callback)(void *));
 //			2 if duplicated key
 int addNode( LIST *pList, void *dataInPtr, void (*callback)(const void *, const void *));
 
+// Inserts data made from keyPtr into list, or merges keyPtr into the existing data
+// (probe before allocate: nothing is allocated for a duplicated key)
+//	keyPtr		borrowed key; it is never stored in list
+//	construct	makes data to store from keyPtr; called only if the key is absent
+//	callback	merges keyPtr into the existing data; called only if the key is present
+//	dataOutPtr	contains the inserted or merged data (if not NULL)
+//	return	0 if overflow
+//			1 if successful
+//			2 if duplicated key
+int upsertNode( LIST *pList, void *keyPtr, void *(*construct)(const void *), void (*callback)(const void *, const void *), void **dataOutPtr);
+
 // Removes data from list
 //	return	0 not found
 //			1 deleted
@@ -53,7 +84,105 @@ int countList( LIST *pList);
 int emptyList( LIST *pList);
 
 // traverses data from list (forward)
-void traverseList( LIST *pList, void (*callback)(const void *));
+// in key order even for self-organizing modes
+//	return	0 if overflow (nothing is traversed)
+//			1 if successful
+int traverseList( LIST *pList, void (*callback)(const void *));
 
 // traverses data from list (backward)
-void traverseListR( LIST *pList, void (*callback)(const void *));
+// in key order even for self-organizing modes
+//	return	0 if overflow (nothing is traversed)
+//			1 if successful
+int traverseListR( LIST *pList, void (*callback)(const void *));
+
+////////////////////////////////////////////////////////////////////////////////
+// cursor functions
+// a cursor is a node position in list; endList is the position past the rear
+// cursors visit self-organizing lists in their current (physical) order
+// erasing at a cursor invalidates only that cursor
+
+// returns the first position (endList if list is empty)
+NODE *beginList( LIST *pList);
+
+// returns the position past the rear
+NODE *endList( LIST *pList);
+
+// returns the next position (endList after the rear)
+NODE *nextNode( LIST *pList, NODE *pos);
+
+// returns the previous position (the rear for endList)
+NODE *prevNode( LIST *pList, NODE *pos);
+
+// returns data at pos (pos must not be endList)
+void *dataAt( NODE *pos);
+
+// Removes data at pos and saves it to dataOutPtr
+//	return	the position following pos
+NODE *eraseAt( LIST *pList, NODE *pos, void **dataOutPtr);
+
+// Inserts data before pos (at the rear for endList) without searching
+// caller must keep the list ordered
+//	return	position of the inserted data
+//			NULL if overflow
+NODE *insertBefore( LIST *pList, NODE *pos, void *dataInPtr);
+
+// Removes all data for which pred returns nonzero in one pass
+// removed data is passed to callback
+//	return	number of removed data
+int removeIf( LIST *pList, int (*pred)(const void *), void (*callback)(void *));
+
+////////////////////////////////////////////////////////////////////////////////
+// deque functions (O(1), no search)
+// push functions do not keep a LIST_ORDERED list ordered; caller must do it
+
+// Inserts data at the head
+//	return	0 if overflow
+//			1 if successful
+int pushFront( LIST *pList, void *dataInPtr);
+
+// Inserts data at the rear
+//	return	0 if overflow
+//			1 if successful
+int pushBack( LIST *pList, void *dataInPtr);
+
+// Removes data at the head and saves it to dataOutPtr
+//	return	0 if list is empty
+//			1 if successful
+int popFront( LIST *pList, void **dataOutPtr);
+
+// Removes data at the rear and saves it to dataOutPtr
+//	return	0 if list is empty
+//			1 if successful
+int popBack( LIST *pList, void **dataOutPtr);
+
+// Moves all nodes of pOther before pos of pList in O(1); pOther becomes empty
+// caller must keep a LIST_ORDERED list ordered
+void spliceList( LIST *pList, NODE *pos, LIST *pOther);
+
+////////////////////////////////////////////////////////////////////////////////
+// set functions for LIST_ORDERED lists with the same compare
+// nodes are relinked, never reallocated; each takes O(n + m)
+
+// Moves all data of pOther into pList in order (sorted union)
+// for a key in both lists, callback merges pOther's data into pList's data
+// and pOther keeps that data (so caller can destroy pOther afterwards)
+//	return	number of duplicated keys
+//			-1 if a list is not LIST_ORDERED
+int mergeLists( LIST *pList, LIST *pOther, void (*callback)(const void *, const void *));
+
+// Moves data not less than keyPtr into a new list
+//	return	list of data not less than keyPtr
+//			NULL if overflow or pList is not LIST_ORDERED
+LIST *splitList( LIST *pList, void *keyPtr);
+
+// Removes data of pList whose key is not in pOther (pList becomes the intersection)
+// removed data is passed to callback; pOther is not changed
+//	return	number of removed data
+//			-1 if a list is not LIST_ORDERED
+int intersectLists( LIST *pList, LIST *pOther, void (*callback)(void *));
+
+// Removes data of pList whose key is in pOther (pList becomes the difference)
+// removed data is passed to callback; pOther is not changed
+//	return	number of removed data
+//			-1 if a list is not LIST_ORDERED
+int differenceLists( LIST *pList, LIST *pOther, void (*callback)(void *));
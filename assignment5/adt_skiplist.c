@@ -0,0 +1,302 @@
+#include <stdlib.h> // malloc
+
+#include "adt_skiplist.h"
+
+// internal node allocation
+// return	node pointer
+// 			NULL if overflow
+static SNODE *_makeNode( int level, void *dataPtr){
+	SNODE *node = (SNODE *)malloc(sizeof(SNODE) + sizeof(node->link[0]) * level);
+	if (!node) return NULL;
+
+	node->dataPtr = dataPtr;
+	node->llink = NULL;
+	node->level = level;
+
+	return node;
+}
+
+// internal random level function
+// returns level in 1 ~ SKIPLIST_MAXLEVEL (promotion probability 1/4)
+static int _randomLevel( SLIST *pList){
+	int level = 1;
+	unsigned int x = pList->seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	pList->seed = x;
+
+	while ((x & 3) == 0 && level < SKIPLIST_MAXLEVEL){
+		level++;
+		x >>= 2;
+	}
+	return level;
+}
+
+// internal search function
+// passes back the rightmost node less than key on each level and its rank
+// return	the first node not less than key (NULL if none)
+static SNODE *_search( SLIST *pList, void *pArgu, SNODE **update, int *rank){
+	SNODE *x = pList->head;
+	int i;
+
+	for (i = pList->level - 1; i >= 0; i--){
+		rank[i] = (i == pList->level - 1) ? 0 : rank[i + 1];
+
+		while (x->link[i].rlink != NULL && pList->compare(x->link[i].rlink->dataPtr, pArgu) < 0){
+			rank[i] += x->link[i].span;
+			x = x->link[i].rlink;
+		}
+		update[i] = x;
+	}
+
+	return x->link[0].rlink;
+}
+
+// internal rank function
+// returns number of data less than key (strict = 1) or not greater than key (strict = 0)
+static int _rank( SLIST *pList, void *pArgu, int strict){
+	SNODE *x = pList->head;
+	int rank = 0;
+	int i;
+
+	for (i = pList->level - 1; i >= 0; i--){
+		while (x->link[i].rlink != NULL){
+			int flag = pList->compare(x->link[i].rlink->dataPtr, pArgu);
+			if (strict ? flag >= 0 : flag > 0) break;
+
+			rank += x->link[i].span;
+			x = x->link[i].rlink;
+		}
+	}
+
+	return rank;
+}
+
+// Allocates dynamic memory for a list head node and returns its address to caller
+// return	head node pointer
+// 			NULL if overflow
+SLIST *createSList( int (*compare)(const void *, const void *)){
+	SLIST *pList = (SLIST *)malloc( sizeof(SLIST));
+	int i;
+
+	if (!pList) return NULL;
+
+	pList->head = _makeNode( SKIPLIST_MAXLEVEL, NULL);
+	if (!pList->head){
+		free( pList);
+		return NULL;
+	}
+	for (i = 0; i < SKIPLIST_MAXLEVEL; i++){
+		pList->head->link[i].rlink = NULL;
+		pList->head->link[i].span = 0;
+	}
+
+	pList->count = 0;
+	pList->level = 1;
+	pList->rear = NULL;
+	pList->seed = 2463534242u;
+	pList->compare = compare;
+
+	return pList;
+}
+
+// Recycles memory of list and nodes; data is passed to callback
+void destroySList( SLIST *pList, void (*callback)(void *)){
+	SNODE *node = pList->head->link[0].rlink;
+	SNODE *next;
+
+	while (node != NULL){
+		next = node->link[0].rlink;
+		(*callback)(node->dataPtr);
+		free( node);
+		node = next;
+	}
+
+	free( pList->head);
+	free( pList);
+}
+
+// Inserts data into list
+//	return	0 if overflow
+//			1 if successful
+//			2 if duplicated key
+int addSNode( SLIST *pList, void *dataInPtr, void (*callback)(const void *, const void *)){
+	SNODE *update[SKIPLIST_MAXLEVEL];
+	int rank[SKIPLIST_MAXLEVEL];
+	SNODE *x;
+	int level;
+	int i;
+
+	x = _search( pList, dataInPtr, update, rank);
+	if (x != NULL && pList->compare(x->dataPtr, dataInPtr) == 0){
+		(*callback)(x->dataPtr, dataInPtr);
+		return 2;
+	}
+
+	level = _randomLevel( pList);
+	x = _makeNode( level, dataInPtr);
+	if (!x) return 0;
+
+	if (level > pList->level){
+		for (i = pList->level; i < level; i++){
+			rank[i] = 0;
+			update[i] = pList->head;
+			update[i]->link[i].span = pList->count;
+		}
+		pList->level = level;
+	}
+
+	for (i = 0; i < level; i++){
+		x->link[i].rlink = update[i]->link[i].rlink;
+		update[i]->link[i].rlink = x;
+
+		// update[i] skipped (rank[0] - rank[i]) nodes to reach update[0]
+		x->link[i].span = update[i]->link[i].span - (rank[0] - rank[i]);
+		update[i]->link[i].span = (rank[0] - rank[i]) + 1;
+	}
+	for (i = level; i < pList->level; i++)
+		update[i]->link[i].span++;
+
+	x->llink = (update[0] == pList->head) ? NULL : update[0];
+	if (x->link[0].rlink != NULL)
+		x->link[0].rlink->llink = x;
+	else
+		pList->rear = x;
+
+	pList->count++;
+	return 1;
+}
+
+// Removes data from list
+//	return	0 not found
+//			1 deleted
+int removeSNode( SLIST *pList, void *keyPtr, void **dataOutPtr){
+	SNODE *update[SKIPLIST_MAXLEVEL];
+	int rank[SKIPLIST_MAXLEVEL];
+	SNODE *x;
+	int i;
+
+	x = _search( pList, keyPtr, update, rank);
+	if (x == NULL || pList->compare(x->dataPtr, keyPtr) != 0)
+		return 0;
+
+	for (i = 0; i < pList->level; i++){
+		if (update[i]->link[i].rlink == x){
+			update[i]->link[i].span += x->link[i].span - 1;
+			update[i]->link[i].rlink = x->link[i].rlink;
+		}
+		else
+			update[i]->link[i].span--;
+	}
+
+	if (x->link[0].rlink != NULL)
+		x->link[0].rlink->llink = x->llink;
+	else
+		pList->rear = x->llink;
+
+	while (pList->level > 1 && pList->head->link[pList->level - 1].rlink == NULL)
+		pList->level--;
+
+	*dataOutPtr = x->dataPtr;
+	free( x);
+	pList->count--;
+	return 1;
+}
+
+// interface to search function
+//	pArgu	key being sought
+//	dataOutPtr	contains found data
+//	return	1 successful
+//			0 not found
+int searchSList( SLIST *pList, void *pArgu, void **dataOutPtr){
+	SNODE *update[SKIPLIST_MAXLEVEL];
+	int rank[SKIPLIST_MAXLEVEL];
+	SNODE *x = _search( pList, pArgu, update, rank);
+
+	if (x != NULL && pList->compare(x->dataPtr, pArgu) == 0){
+		*dataOutPtr = x->dataPtr;
+		return 1;
+	}
+	return 0;
+}
+
+// returns number of nodes in list
+int countSList( SLIST *pList){
+	return pList->count;
+}
+
+// returns	1 empty
+//			0 list has data
+int emptySList( SLIST *pList){
+	return !pList->count ? 1 : 0;
+}
+
+// traverses data from list (forward)
+void traverseSList( SLIST *pList, void (*callback)(const void *)){
+	SNODE *node = pList->head->link[0].rlink;
+
+	while (node != NULL){
+		(*callback)(node->dataPtr);
+		node = node->link[0].rlink;
+	}
+}
+
+// traverses data from list (backward)
+void traverseSListR( SLIST *pList, void (*callback)(const void *)){
+	SNODE *node = pList->rear;
+
+	while (node != NULL){
+		(*callback)(node->dataPtr);
+		node = node->llink;
+	}
+}
+
+// returns number of data less than or equal to keyPtr
+// (1-based rank of keyPtr if it is in list)
+int rankOf( SLIST *pList, void *keyPtr){
+	return _rank( pList, keyPtr, 0);
+}
+
+// passes back the k-th (1-based) data in order
+//	return	1 successful
+//			0 k is out of range
+int selectK( SLIST *pList, int k, void **dataOutPtr){
+	SNODE *x = pList->head;
+	int traversed = 0;
+	int i;
+
+	if (k < 1 || k > pList->count) return 0;
+
+	for (i = pList->level - 1; i >= 0; i--){
+		while (x->link[i].rlink != NULL && traversed + x->link[i].span <= k){
+			traversed += x->link[i].span;
+			x = x->link[i].rlink;
+		}
+		if (traversed == k){
+			*dataOutPtr = x->dataPtr;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// returns number of data in [loPtr, hiPtr]
+int countRange( SLIST *pList, void *loPtr, void *hiPtr){
+	if (pList->compare(loPtr, hiPtr) > 0) return 0;
+
+	return _rank( pList, hiPtr, 0) - _rank( pList, loPtr, 1);
+}
+
+// traverses data in [loPtr, hiPtr] (forward)
+void traverseRange( SLIST *pList, void *loPtr, void *hiPtr, void (*callback)(const void *)){
+	SNODE *update[SKIPLIST_MAXLEVEL];
+	int rank[SKIPLIST_MAXLEVEL];
+	SNODE *node = _search( pList, loPtr, update, rank);
+
+	while (node != NULL && pList->compare(node->dataPtr, hiPtr) <= 0){
+		(*callback)(node->dataPtr);
+		node = node->link[0].rlink;
+	}
+}
@@ -0,0 +1,87 @@
+#define SKIPLIST_MAXLEVEL	32
+
+////////////////////////////////////////////////////////////////////////////////
+// Indexable skip list (ordered list with rank, select and range queries)
+// every link keeps its span (number of level-0 steps it skips), so that
+// rankOf, selectK and countRange take O(log n) expected time
+
+////////////////////////////////////////////////////////////////////////////////
+// SLIST type definition
+typedef struct snode
+{
+	void			*dataPtr;
+	struct snode	*llink;		// backward link (level 0)
+	int				level;
+	struct
+	{
+		struct snode	*rlink;
+		int				span;
+	} link[];					// forward links (level 0 ~ level - 1)
+} SNODE;
+
+typedef struct
+{
+	int				count;
+	int				level;		// highest level in use
+	SNODE			*head;		// header node (no data)
+	SNODE			*rear;
+	unsigned int	seed;		// random level generator state
+	int				(*compare)(const void *, const void *);
+} SLIST;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// Allocates dynamic memory for a list head node and returns its address to caller
+// return	head node pointer
+// 			NULL if overflow
+SLIST *createSList( int (*compare)(const void *, const void *));
+
+// Recycles memory of list and nodes; data is passed to callback
+void destroySList( SLIST *pList, void (*callback)(void *));
+
+// Inserts data into list
+//	return	0 if overflow
+//			1 if successful
+//			2 if duplicated key
+int addSNode( SLIST *pList, void *dataInPtr, void (*callback)(const void *, const void *));
+
+// Removes data from list
+//	return	0 not found
+//			1 deleted
+int removeSNode( SLIST *pList, void *keyPtr, void **dataOutPtr);
+
+// interface to search function
+//	pArgu	key being sought
+//	dataOutPtr	contains found data
+//	return	1 successful
+//			0 not found
+int searchSList( SLIST *pList, void *pArgu, void **dataOutPtr);
+
+// returns number of nodes in list
+int countSList( SLIST *pList);
+
+// returns	1 empty
+//			0 list has data
+int emptySList( SLIST *pList);
+
+// traverses data from list (forward)
+void traverseSList( SLIST *pList, void (*callback)(const void *));
+
+// traverses data from list (backward)
+void traverseSListR( SLIST *pList, void (*callback)(const void *));
+
+// returns number of data less than or equal to keyPtr
+// (1-based rank of keyPtr if it is in list)
+int rankOf( SLIST *pList, void *keyPtr);
+
+// passes back the k-th (1-based) data in order
+//	return	1 successful
+//			0 k is out of range
+int selectK( SLIST *pList, int k, void **dataOutPtr);
+
+// returns number of data in [loPtr, hiPtr]
+int countRange( SLIST *pList, void *loPtr, void *hiPtr);
+
+// traverses data in [loPtr, hiPtr] (forward)
+void traverseRange( SLIST *pList, void *loPtr, void *hiPtr, void (*callback)(const void *));
@@ -0,0 +1,206 @@
+#ifndef ADT_TDLIST_H
+#define ADT_TDLIST_H
+
+#include <stdlib.h> // malloc
+
+////////////////////////////////////////////////////////////////////////////////
+// Type-specialized doubly linked ordered list
+//
+// DLIST_DEFINE( list, T, cmp) generates a list of T stored by value in nodes
+// with the same operations as adt_dlist.h; cmp is called directly so that
+// the compiler can inline it.
+//	cmp		int cmp( const T *, const T *)
+//
+// generated types
+//	list			LIST of T
+//	list##_node		NODE of T
+//
+// generated functions (same meaning as in adt_dlist.h)
+//	list *list##_create( void);
+//	void list##_destroy( list *pList, void (*callback)(T *));
+//	int list##_add( list *pList, const T *dataInPtr, void (*callback)(T *, const T *));
+//	int list##_upsert( list *pList, const T *keyPtr, int (*construct)(T *, const T *), void (*callback)(T *, const T *));
+//	int list##_remove( list *pList, const T *keyPtr, T *dataOutPtr);
+//	int list##_search( list *pList, const T *pArgu, T **dataOutPtr);
+//	int list##_count( list *pList);
+//	int list##_empty( list *pList);
+//	void list##_traverse( list *pList, void (*callback)(const T *));
+//	void list##_traverseR( list *pList, void (*callback)(const T *));
+
+#define DLIST_DEFINE( list, T, cmp)												\
+																				\
+typedef struct list##_node														\
+{																				\
+	T						data;												\
+	struct list##_node		*llink;												\
+	struct list##_node		*rlink;												\
+} list##_node;																	\
+																				\
+typedef struct																	\
+{																				\
+	int				count;														\
+	list##_node		*head;														\
+	list##_node		*rear;														\
+} list;																			\
+																				\
+/* links an allocated node into list after pPre (at head if pPre is NULL) */	\
+static inline void list##__link( list *pList, list##_node *pPre, list##_node *pNew)	\
+{																				\
+	pNew->llink = pPre;															\
+	pNew->rlink = pPre ? pPre->rlink : pList->head;								\
+																				\
+	if (pNew->rlink) pNew->rlink->llink = pNew;									\
+	else pList->rear = pNew;													\
+																				\
+	if (pPre) pPre->rlink = pNew;												\
+	else pList->head = pNew;													\
+																				\
+	pList->count++;																\
+}																				\
+																				\
+/* unlinks pLoc from list and recycles it */									\
+static inline void list##__delete( list *pList, list##_node *pLoc, T *dataOutPtr)	\
+{																				\
+	*dataOutPtr = pLoc->data;													\
+																				\
+	if (pLoc->llink) pLoc->llink->rlink = pLoc->rlink;							\
+	else pList->head = pLoc->rlink;												\
+																				\
+	if (pLoc->rlink) pLoc->rlink->llink = pLoc->llink;							\
+	else pList->rear = pLoc->llink;												\
+																				\
+	pList->count--;																\
+	free( pLoc);																\
+}																				\
+																				\
+/* return 1 found (pLoc), 0 not found (pPre is logical predecessor) */			\
+static inline int list##__search( list *pList, list##_node **pPre, list##_node **pLoc, const T *pArgu)	\
+{																				\
+	list##_node *pre = NULL;													\
+	list##_node *loc = pList->head;												\
+	int flag = 1;																\
+																				\
+	while (loc != NULL)															\
+	{																			\
+		flag = cmp( pArgu, &loc->data);											\
+		if (flag <= 0) break;													\
+		pre = loc;																\
+		loc = loc->rlink;														\
+	}																			\
+	*pPre = pre;																\
+	*pLoc = loc;																\
+	return loc != NULL && flag == 0;											\
+}																				\
+																				\
+static inline list *list##_create( void)										\
+{																				\
+	list *pList = (list *)malloc( sizeof(list));								\
+	if (!pList) return NULL;													\
+																				\
+	pList->count = 0;															\
+	pList->head = NULL;															\
+	pList->rear = NULL;															\
+	return pList;																\
+}																				\
+																				\
+static inline void list##_destroy( list *pList, void (*callback)(T *))			\
+{																				\
+	list##_node *ptr;															\
+																				\
+	while (pList->head != NULL)													\
+	{																			\
+		ptr = pList->head;														\
+		pList->head = ptr->rlink;												\
+		if (callback) callback( &ptr->data);									\
+		free( ptr);																\
+	}																			\
+	free( pList);																\
+}																				\
+																				\
+static inline int list##_add( list *pList, const T *dataInPtr, void (*callback)(T *, const T *))	\
+{																				\
+	list##_node *pPre, *pLoc;													\
+																				\
+	if (list##__search( pList, &pPre, &pLoc, dataInPtr))						\
+	{																			\
+		callback( &pLoc->data, dataInPtr);										\
+		return 2;																\
+	}																			\
+																				\
+	pLoc = (list##_node *)malloc( sizeof(list##_node));							\
+	if (!pLoc) return 0;														\
+	pLoc->data = *dataInPtr;													\
+																				\
+	list##__link( pList, pPre, pLoc);											\
+	return 1;																	\
+}																				\
+																				\
+static inline int list##_upsert( list *pList, const T *keyPtr, int (*construct)(T *, const T *), void (*callback)(T *, const T *))	\
+{																				\
+	list##_node *pPre, *pLoc;													\
+																				\
+	if (list##__search( pList, &pPre, &pLoc, keyPtr))							\
+	{																			\
+		callback( &pLoc->data, keyPtr);											\
+		return 2;																\
+	}																			\
+																				\
+	pLoc = (list##_node *)malloc( sizeof(list##_node));							\
+	if (!pLoc) return 0;														\
+	if (!construct( &pLoc->data, keyPtr))										\
+	{																			\
+		free( pLoc);															\
+		return 0;																\
+	}																			\
+																				\
+	list##__link( pList, pPre, pLoc);											\
+	return 1;																	\
+}																				\
+																				\
+static inline int list##_remove( list *pList, const T *keyPtr, T *dataOutPtr)	\
+{																				\
+	list##_node *pPre, *pLoc;													\
+																				\
+	if (!list##__search( pList, &pPre, &pLoc, keyPtr)) return 0;				\
+																				\
+	list##__delete( pList, pLoc, dataOutPtr);									\
+	return 1;																	\
+}																				\
+																				\
+static inline int list##_search( list *pList, const T *pArgu, T **dataOutPtr)	\
+{																				\
+	list##_node *pPre, *pLoc;													\
+																				\
+	if (!list##__search( pList, &pPre, &pLoc, pArgu)) return 0;				\
+																				\
+	*dataOutPtr = &pLoc->data;													\
+	return 1;																	\
+}																				\
+																				\
+static inline int list##_count( list *pList)									\
+{																				\
+	return pList->count;														\
+}																				\
+																				\
+static inline int list##_empty( list *pList)									\
+{																				\
+	return !pList->count ? 1 : 0;												\
+}																				\
+																				\
+static inline void list##_traverse( list *pList, void (*callback)(const T *))	\
+{																				\
+	list##_node *node;															\
+																				\
+	for (node = pList->head; node != NULL; node = node->rlink)					\
+		callback( &node->data);													\
+}																				\
+																				\
+static inline void list##_traverseR( list *pList, void (*callback)(const T *))	\
+{																				\
+	list##_node *node;															\
+																				\
+	for (node = pList->rear; node != NULL; node = node->llink)					\
+		callback( &node->data);													\
+}
+
+#endif
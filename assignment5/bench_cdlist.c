@@ -0,0 +1,183 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, atoi
+#include <pthread.h>
+#include <time.h> // clock_gettime
+#include <unistd.h> // sysconf
+
+#include "adt_dlist.h"
+#include "adt_cdlist.h"
+
+#define KEY_RANGE		1024	// keys are 0 ~ KEY_RANGE - 1
+#define OPS_PER_THREAD	200000
+
+// operation mix (percent)
+#define SEARCH_RATIO	80
+#define INSERT_RATIO	10	// the rest is delete
+
+////////////////////////////////////////////////////////////////////////////////
+// Multi-threaded stress and scaling benchmark
+// compares adt_cdlist with adt_dlist behind one global mutex
+//	usage: bench_cdlist [MAX_THREADS]
+
+static int keys[KEY_RANGE];
+
+static LIST *glist;
+static pthread_mutex_t glock = PTHREAD_MUTEX_INITIALIZER;
+static CLIST *clist;
+
+typedef struct
+{
+	unsigned int	seed;
+	int				concurrent;	// 1 adt_cdlist, 0 adt_dlist + global mutex
+	long long		found;
+} tWorker;
+
+int cmpInt( const void *p1, const void *p2)
+{
+	return *(const int *)p1 - *(const int *)p2;
+}
+
+void no_merge( const void *dataOutPtr, const void *dataInPtr)
+{
+}
+
+void no_free( void *dataPtr)
+{
+}
+
+// xorshift random number generator (one per thread)
+static unsigned int next_rand( unsigned int *seed)
+{
+	unsigned int x = *seed;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *seed = x;
+}
+
+static double now_sec( void)
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+void *worker( void *arg)
+{
+	tWorker *w = (tWorker *)arg;
+	void *ptr;
+	int i;
+
+	for (i = 0; i < OPS_PER_THREAD; i++)
+	{
+		int op = next_rand( &w->seed) % 100;
+		int *key = &keys[next_rand( &w->seed) % KEY_RANGE];
+
+		if (w->concurrent)
+		{
+			if (op < SEARCH_RATIO) w->found += searchCList( clist, key, &ptr);
+			else if (op < SEARCH_RATIO + INSERT_RATIO) addCNode( clist, key, no_merge);
+			else removeCNode( clist, key, &ptr);
+		}
+		else
+		{
+			pthread_mutex_lock( &glock);
+			if (op < SEARCH_RATIO) w->found += searchList( glist, key, &ptr);
+			else if (op < SEARCH_RATIO + INSERT_RATIO) addNode( glist, key, no_merge);
+			else removeNode( glist, key, &ptr);
+			pthread_mutex_unlock( &glock);
+		}
+	}
+	return NULL;
+}
+
+// runs nthreads workers and returns throughput (ops/sec)
+static double run( int nthreads, int concurrent)
+{
+	pthread_t *tid = (pthread_t *)malloc( sizeof(pthread_t) * nthreads);
+	tWorker *w = (tWorker *)malloc( sizeof(tWorker) * nthreads);
+	double t0, elapsed;
+	int i;
+
+	t0 = now_sec();
+	for (i = 0; i < nthreads; i++)
+	{
+		w[i].seed = 2022 + i * 7919;
+		w[i].concurrent = concurrent;
+		w[i].found = 0;
+		pthread_create( &tid[i], NULL, worker, &w[i]);
+	}
+	for (i = 0; i < nthreads; i++)
+		pthread_join( tid[i], NULL);
+	elapsed = now_sec() - t0;
+
+	free( tid);
+	free( w);
+
+	return (double)nthreads * OPS_PER_THREAD / elapsed;
+}
+
+// checks that the list is strictly ordered and count matches
+static int check_cdlist( CLIST *pList)
+{
+	CNODE *node;
+	int n = 0;
+	int prev = -1;
+
+	for (node = pList->head->link; node != pList->tail; node = node->link)
+	{
+		if (node->marked || *(int *)node->dataPtr <= prev) return 0;
+		prev = *(int *)node->dataPtr;
+		n++;
+	}
+	return n == countCList( pList);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main( int argc, char **argv)
+{
+	int max_threads = (int)sysconf( _SC_NPROCESSORS_ONLN) * 2;
+	int nthreads;
+	int i;
+
+	if (argc == 2) max_threads = atoi( argv[1]);
+	if (max_threads < 1) max_threads = 1;
+
+	for (i = 0; i < KEY_RANGE; i++) keys[i] = i;
+
+	printf( "key range %d, %d ops/thread, search %d%% insert %d%% delete %d%%\n",
+		KEY_RANGE, OPS_PER_THREAD, SEARCH_RATIO, INSERT_RATIO, 100 - SEARCH_RATIO - INSERT_RATIO);
+	printf( "%8s %18s %18s\n", "threads", "global lock (op/s)", "adt_cdlist (op/s)");
+
+	// 1, 2, 4, ..., max_threads
+	for (nthreads = 1; nthreads <= max_threads;
+		nthreads = (nthreads < max_threads && nthreads * 2 > max_threads) ? max_threads : nthreads * 2)
+	{
+		double tput1, tput2;
+
+		// half-full lists
+		glist = createList( cmpInt);
+		clist = createCList( cmpInt);
+		for (i = 0; i < KEY_RANGE; i += 2)
+		{
+			addNode( glist, &keys[i], no_merge);
+			addCNode( clist, &keys[i], no_merge);
+		}
+
+		tput1 = run( nthreads, 0);
+		tput2 = run( nthreads, 1);
+
+		printf( "%8d %18.0f %18.0f\n", nthreads, tput1, tput2);
+
+		if (!check_cdlist( clist))
+		{
+			fprintf( stderr, "Error: adt_cdlist is corrupted after %d threads\n", nthreads);
+			return 1;
+		}
+
+		destroyList( glist, no_free);
+		destroyCList( clist, no_free);
+	}
+
+	return 0;
+}
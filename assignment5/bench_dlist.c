@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, atoi
+#include <string.h> // strcmp, strdup
+#include <time.h> // clock_gettime
+
+#include "adt_dlist.h"
+#include "adt_tdlist.h"
+
+#define MAX_NAMES	100000
+
+// User structure type definition
+typedef struct
+{
+	char	*name;	// 이름
+	int		freq;	// 빈도
+} tName;
+
+////////////////////////////////////////////////////////////////////////////////
+// generic list (adt_dlist) callbacks
+
+int cmpName( const void *pName1, const void *pName2)
+{
+	return strcmp( ((tName *)pName1)->name, ((tName *)pName2)->name);
+}
+
+void increase_freq( const void *dataOutPtr, const void *dataInPtr)
+{
+	((tName *)dataOutPtr)->freq += ((tName *)dataInPtr)->freq;
+}
+
+void *copyName( const void *pName)
+{
+	tName *tname = (tName *)malloc( sizeof(tName));
+	if (!tname) return NULL;
+
+	tname->name = strdup( ((tName *)pName)->name);
+	tname->freq = ((tName *)pName)->freq;
+	return tname;
+}
+
+void destroyName( void *pName)
+{
+	free( ((tName *)pName)->name);
+	free( pName);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// type-specialized list (adt_tdlist) callbacks
+
+static inline int cmp_inline( const tName *pName1, const tName *pName2)
+{
+	return strcmp( pName1->name, pName2->name);
+}
+
+DLIST_DEFINE( name_list, tName, cmp_inline)
+
+void increase_freq_t( tName *dataOutPtr, const tName *dataInPtr)
+{
+	dataOutPtr->freq += dataInPtr->freq;
+}
+
+int construct_t( tName *dataOutPtr, const tName *keyPtr)
+{
+	dataOutPtr->name = strdup( keyPtr->name);
+	dataOutPtr->freq = keyPtr->freq;
+	return dataOutPtr->name != NULL;
+}
+
+void destroy_t( tName *pName)
+{
+	free( pName->name);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// returns monotonic clock in seconds
+static double now_sec( void)
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Compares load and search time of adt_dlist and DLIST_DEFINE lists
+//	usage: bench_dlist FILE [ROUNDS]
+int main( int argc, char **argv)
+{
+	tName *rows;
+	char name[100];
+	int freq;
+	int n = 0;
+	int rounds = 3;
+	long long found1 = 0, found2 = 0;
+	double t0, load1, load2, search1, search2;
+	LIST *list1;
+	name_list *list2;
+	FILE *fp;
+	int i, r;
+
+	if (argc != 2 && argc != 3)
+	{
+		fprintf( stderr, "usage: %s FILE [ROUNDS]\n", argv[0]);
+		return 1;
+	}
+	if (argc == 3) rounds = atoi( argv[2]);
+
+	fp = fopen( argv[1], "rt");
+	if (!fp)
+	{
+		fprintf( stderr, "Error: cannot open file [%s]\n", argv[1]);
+		return 2;
+	}
+
+	rows = (tName *)malloc( sizeof(tName) * MAX_NAMES);
+	if (!rows) return 100;
+
+	while (n < MAX_NAMES && fscanf( fp, "%*d\t%99s\t%*c\t%d", name, &freq) == 2)
+	{
+		rows[n].name = strdup( name);
+		rows[n].freq = freq;
+		n++;
+	}
+	fclose( fp);
+
+	// load
+	t0 = now_sec();
+	list1 = createList( cmpName);
+	for (i = 0; i < n; i++)
+		upsertNode( list1, &rows[i], copyName, increase_freq, NULL);
+	load1 = now_sec() - t0;
+
+	t0 = now_sec();
+	list2 = name_list_create();
+	for (i = 0; i < n; i++)
+		name_list_upsert( list2, &rows[i], construct_t, increase_freq_t);
+	load2 = now_sec() - t0;
+
+	if (countList( list1) != name_list_count( list2))
+	{
+		fprintf( stderr, "Error: count mismatch (%d, %d)\n", countList( list1), name_list_count( list2));
+		return 3;
+	}
+
+	// search
+	t0 = now_sec();
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < n; i++)
+		{
+			void *ptr;
+			found1 += searchList( list1, &rows[i], &ptr);
+		}
+	search1 = now_sec() - t0;
+
+	t0 = now_sec();
+	for (r = 0; r < rounds; r++)
+		for (i = 0; i < n; i++)
+		{
+			tName *ptr;
+			found2 += name_list_search( list2, &rows[i], &ptr);
+		}
+	search2 = now_sec() - t0;
+
+	printf( "%d rows, %d distinct names, %d search rounds\n", n, countList( list1), rounds);
+	printf( "%-12s %12s %12s %14s\n", "list", "load (ms)", "search (ms)", "ns/search");
+	printf( "%-12s %12.2f %12.2f %14.1f\n", "adt_dlist", load1 * 1e3, search1 * 1e3, search1 * 1e9 / ((double)n * rounds));
+	printf( "%-12s %12.2f %12.2f %14.1f\n", "DLIST_DEFINE", load2 * 1e3, search2 * 1e3, search2 * 1e9 / ((double)n * rounds));
+	if (found1 != found2) fprintf( stderr, "Error: search mismatch\n");
+
+	destroyList( list1, destroyName);
+	name_list_destroy( list2, destroy_t);
+	for (i = 0; i < n; i++) free( rows[i].name);
+	free( rows);
+
+	return found1 != found2;
+}
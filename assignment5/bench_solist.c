@@ -0,0 +1,134 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc
+#include <string.h> // strcmp, strdup
+#include <ctype.h> // toupper
+#include <time.h> // clock_gettime
+
+#include "adt_dlist.h"
+
+#define MAX_LINE	256
+
+// User structure type definition
+typedef struct
+{
+	char	*name;	// 이름
+	int		freq;	// 빈도
+} tName;
+
+int cmpName( const void *pName1, const void *pName2)
+{
+	return strcmp( ((tName *)pName1)->name, ((tName *)pName2)->name);
+}
+
+void increase_freq( const void *dataOutPtr, const void *dataInPtr)
+{
+	((tName *)dataOutPtr)->freq += ((tName *)dataInPtr)->freq;
+}
+
+void *copyName( const void *pName)
+{
+	tName *tname = (tName *)malloc( sizeof(tName));
+	if (!tname) return NULL;
+
+	tname->name = strdup( ((tName *)pName)->name);
+	tname->freq = ((tName *)pName)->freq;
+	return tname;
+}
+
+void destroyName( void *pName)
+{
+	free( ((tName *)pName)->name);
+	free( pName);
+}
+
+static double now_sec( void)
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replays the S commands of a command script (see gen_cmds) against every
+// list mode and reports average search depth (nodes compared per search)
+//	usage: bench_solist FILE SCRIPT
+int main( int argc, char **argv)
+{
+	static const char *label[] = { "ordered", "move-to-front", "transpose", "count"};
+	char **queries = NULL;
+	int nqueries = 0, capacity = 0;
+	char line[MAX_LINE];
+	char name[100];
+	int freq;
+	FILE *fp;
+	int mode, i;
+
+	if (argc != 3)
+	{
+		fprintf( stderr, "usage: %s FILE SCRIPT\n", argv[0]);
+		return 1;
+	}
+
+	fp = fopen( argv[2], "rt");
+	if (!fp)
+	{
+		fprintf( stderr, "Error: cannot open file [%s]\n", argv[2]);
+		return 2;
+	}
+	while (fgets( line, MAX_LINE, fp) != NULL)
+	{
+		if (toupper( (unsigned char)line[0]) != 'S' || sscanf( line + 1, "%99s", name) != 1) continue;
+
+		if (nqueries == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 1024;
+			queries = (char **)realloc( queries, sizeof(char *) * capacity);
+			if (!queries) return 100;
+		}
+		queries[nqueries++] = strdup( name);
+	}
+	fclose( fp);
+
+	printf( "%d searches\n", nqueries);
+	printf( "%-14s %12s %12s %12s\n", "mode", "avg depth", "search (ms)", "found");
+
+	for (mode = LIST_ORDERED; mode <= LIST_FREQ_COUNT; mode++)
+	{
+		LIST *list = createListMode( cmpName, mode);
+		long long found = 0;
+		double t0, elapsed;
+
+		fp = fopen( argv[1], "rt");
+		if (!fp)
+		{
+			fprintf( stderr, "Error: cannot open file [%s]\n", argv[1]);
+			return 2;
+		}
+		while (fscanf( fp, "%*d\t%99s\t%*c\t%d", name, &freq) == 2)
+		{
+			tName key = { name, freq};
+			upsertNode( list, &key, copyName, increase_freq, NULL);
+		}
+		fclose( fp);
+
+		list->probes = 0;
+		t0 = now_sec();
+		for (i = 0; i < nqueries; i++)
+		{
+			tName key = { queries[i], 0};
+			void *ptr;
+			found += searchList( list, &key, &ptr);
+		}
+		elapsed = now_sec() - t0;
+
+		printf( "%-14s %12.1f %12.2f %12lld\n", label[mode],
+			nqueries ? (double)list->probes / nqueries : 0.0, elapsed * 1e3, found);
+
+		destroyList( list, destroyName);
+	}
+
+	for (i = 0; i < nqueries; i++) free( queries[i]);
+	free( queries);
+
+	return 0;
+}
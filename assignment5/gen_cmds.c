@@ -0,0 +1,121 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, realloc, rand, atoi, atof
+#include <string.h> // strcpy, strcmp
+#include <math.h> // pow
+
+#define MAX_NAMES	100000
+
+// command mix (percent)
+#define SEARCH_RATIO	90
+#define DELETE_RATIO	5	// the rest is COUNT
+
+////////////////////////////////////////////////////////////////////////////////
+// Generates a command script for batch mode of name5 (name5 -b SCRIPT FILE)
+// names in FILE are ranked in random order and drawn with Zipf distribution
+//	usage: gen_cmds FILE NUM [SKEW]
+//	SKEW	Zipf exponent (default 1.0, 0 means uniform)
+
+// returns random number in [0, 1)
+static double rand_unit( void)
+{
+	return rand() / ((double)RAND_MAX + 1.0);
+}
+
+// returns index of the first cdf value greater than u
+static int zipf_index( const double *cdf, int n, double u)
+{
+	int lo = 0, hi = n - 1;
+
+	while (lo < hi)
+	{
+		int mid = (lo + hi) / 2;
+		if (cdf[mid] > u) hi = mid;
+		else lo = mid + 1;
+	}
+	return lo;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main( int argc, char **argv)
+{
+	char (*names)[100];
+	double *cdf;
+	char name[100];
+	int freq;
+	int n = 0;
+	int num;
+	double skew = 1.0;
+	double sum = 0.0;
+	FILE *fp;
+	int i;
+
+	if (argc != 3 && argc != 4)
+	{
+		fprintf( stderr, "usage: %s FILE NUM [SKEW]\n", argv[0]);
+		return 1;
+	}
+
+	num = atoi( argv[2]);
+	if (argc == 4) skew = atof( argv[3]);
+
+	fp = fopen( argv[1], "rt");
+	if (!fp)
+	{
+		fprintf( stderr, "Error: cannot open file [%s]\n", argv[1]);
+		return 2;
+	}
+
+	names = malloc( sizeof(*names) * MAX_NAMES);
+	cdf = (double *)malloc( sizeof(double) * MAX_NAMES);
+	if (!names || !cdf)
+	{
+		fprintf( stderr, "Error: out of memory\n");
+		return 100;
+	}
+
+	while (n < MAX_NAMES && fscanf( fp, "%*d\t%99s\t%*c\t%d", name, &freq) == 2)
+		strcpy( names[n++], name);
+	fclose( fp);
+
+	if (n == 0)
+	{
+		fprintf( stderr, "Error: no names in [%s]\n", argv[1]);
+		return 3;
+	}
+
+	srand( 2022);
+
+	// random ranks, so that popularity does not follow file (insertion) order
+	for (i = n - 1; i > 0; i--)
+	{
+		int j = rand() % (i + 1);
+		strcpy( name, names[i]);
+		strcpy( names[i], names[j]);
+		strcpy( names[j], name);
+	}
+
+	// cumulative distribution of rank i: 1 / (i + 1)^skew
+	for (i = 0; i < n; i++)
+	{
+		sum += 1.0 / pow( i + 1, skew);
+		cdf[i] = sum;
+	}
+	for (i = 0; i < n; i++) cdf[i] /= sum;
+
+	for (i = 0; i < num; i++)
+	{
+		int r = rand() % 100;
+
+		if (r < SEARCH_RATIO)
+			printf( "S %s\n", names[zipf_index( cdf, n, rand_unit())]);
+		else if (r < SEARCH_RATIO + DELETE_RATIO)
+			printf( "D %s\n", names[zipf_index( cdf, n, rand_unit())]);
+		else
+			printf( "C\n");
+	}
+
+	free( names);
+	free( cdf);
+
+	return 0;
+}
@@ -1,9 +1,13 @@
 #include <stdio.h>
 #include <stdlib.h> // malloc
 #include <string.h> // strdup, strcmp
-#include <ctype.h> // toupper
+#include <ctype.h> // toupper, isspace
+#include <time.h> // clock_gettime
+#include <unistd.h> // _exit
 
 #include "adt_dlist.h"
+#include "adt_skiplist.h"
+#include "wal.h"
 
 #define QUIT			1
 #define FORWARD_PRINT	2
@@ -11,7 +15,20 @@
 #define SEARCH			4
 #define DELETE			5
 #define COUNT			6
+#define RANK			7
+#define SELECT			8
+#define COUNT_RANGE		9
+#define LIST_RANGE		10
+#define ADD				11
+#define MAX_ACTION		11
 
+#define PROMPT	"Select Q)uit, P)rint, B)ackward print, S)earch, A)dd, D)elete, C)ount, R)ank, K)-th, N)umber in range, L)ist range: "
+
+#define GROUP_COMMIT		64		// log records per fsync
+#define CHECKPOINT_INTERVAL	100000	// log records between checkpoints
+
+#define BATCH_BUFSIZE	(1 << 16)	// stdout buffer size in batch mode
+#define MAX_LINE		256
 
 // User structure type definition
 typedef struct 
@@ -20,6 +37,25 @@ typedef struct
 	int		freq;	// 빈도
 } tName;
 
+// Name lists used by commands
+typedef struct
+{
+	LIST	*list;	// ordered name list (owns name structures)
+	SLIST	*index;	// indexable skip list over the same name structures
+	WAL		*wal;	// operation log (NULL if not persistent)
+	NODE	*merge;	// list position of the log replay (NULL before the first record)
+	int		checkpointAt;	// log records at which log_op takes the next checkpoint
+} tNames;
+
+// Command statistics for batch mode
+typedef struct
+{
+	int			count[MAX_ACTION + 1];	// 명령별 실행 횟수 (index 0: undefined)
+	long long	*latency;			// 명령별 실행 시간 (ns)
+	int			len;
+	int			capacity;
+} tStat;
+
 ////////////////////////////////////////////////////////////////////////////////
 // Allocates dynamic memory for a name structure, initialize fields(name, freq) and returns its address to caller
 //	return	name structure pointer
@@ -29,6 +65,13 @@ tName *createName( char *name, int freq);
 // Deletes all data in name structure and recycles memory
 void destroyName( void *pName);
 
+// Allocates a copy of a (borrowed) name structure
+// for upsertNode function
+void *copyName( const void *pName);
+
+// Does nothing; for destroySList function (index does not own names)
+void no_destroy( void *pName);
+
 ////////////////////////////////////////////////////////////////////////////////
 // prints contents of name structure
 // for traverseList and traverseListR functions
@@ -46,12 +89,9 @@ void increase_freq(const void *dataOutPtr, const void *dataInPtr)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-/* gets user's input
-*/
-int get_action()
+// converts a command character to action
+int char_to_action( char ch)
 {
-	char ch;
-	scanf( "%c", &ch);
 	ch = toupper( ch);
 	switch( ch)
 	{
@@ -67,10 +107,29 @@ int get_action()
 			return DELETE;
 		case 'C':
 			return COUNT;
+		case 'R':
+			return RANK;
+		case 'K':
+			return SELECT;
+		case 'N':
+			return COUNT_RANGE;
+		case 'L':
+			return LIST_RANGE;
+		case 'A':
+			return ADD;
 	}
 	return 0; // undefined action
 }
 
+/* gets user's input
+*/
+int get_action()
+{
+	char ch;
+	if (scanf( "%c", &ch) == EOF) return QUIT;
+	return char_to_action( ch);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // compares two names in name structures
 // for createList function
@@ -79,107 +138,554 @@ int cmpName( const void *pName1, const void *pName2)
 	return strcmp( ((tName *)pName1)->name, ((tName *)pName2)->name);
 }
 
+// returns number of arguments of action
+int action_args( int action)
+{
+	switch( action)
+	{
+		case SEARCH:
+		case DELETE:
+		case RANK:
+		case SELECT:
+			return 1;
+		case COUNT_RANGE:
+		case LIST_RANGE:
+		case ADD:
+			return 2;
+	}
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// adds freq of name to the name lists (inserts name if new)
+//	return	0 if overflow
+//			1 if inserted
+//			2 if merged into existing name
+int add_name( tNames *names, char *name, int freq)
+{
+	tName key = { name, freq};
+	void *ptr;
+	int ret = upsertNode( names->list, &key, copyName, increase_freq, &ptr);
+	
+	if (ret == 1 && !addSNode( names->index, ptr, increase_freq))
+	{
+		// the index cannot take the new name: the list must not keep it either
+		if (removeNode( names->list, &key, &ptr)) destroyName( ptr);
+		return 0;
+	}
+	return ret;
+}
+
+// removes name from the name lists
+//	return	removed name structure (caller destroys it)
+//			NULL if not found
+tName *delete_name( tNames *names, char *name)
+{
+	tName key = { name, 0};
+	void *ptr;
+	
+	if (removeSNode( names->index, &key, &ptr) && removeNode( names->list, &key, &ptr))
+		return (tName *)ptr;
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// writes all names in list order to a new checkpoint
+//	return	0 if I/O error
+//			1 if successful
+int checkpoint_names( tNames *names)
+{
+	LIST *list = names->list;
+	NODE *pos;
+	
+	if (!wal_CheckpointBegin( names->wal, countList( list)))
+	{
+		wal_CheckpointAbort( names->wal);
+		return 0;
+	}
+	
+	for (pos = beginList( list); pos != endList( list); pos = nextNode( list, pos))
+	{
+		tName *pName = (tName *)dataAt( pos);
+		if (!wal_CheckpointWrite( names->wal, pName->name, pName->freq))
+		{
+			wal_CheckpointAbort( names->wal);
+			return 0;
+		}
+	}
+	return wal_CheckpointEnd( names->wal);
+}
+
+// the log cannot be written or synced: the results not acknowledged yet are
+// discarded (_exit does not flush stdout) and so is the state in memory
+void fail_log( void)
+{
+	fprintf( stderr, "Error: cannot write log; unacknowledged results are discarded\n");
+	_exit( 3);
+}
+
+// appends an operation to the log; takes a checkpoint every CHECKPOINT_INTERVAL records
+// (a failed checkpoint is tried again CHECKPOINT_INTERVAL records later)
+// the program stops if the log cannot be written (fail_log)
+void log_op( tNames *names, int op, char *name, int freq)
+{
+	if (!names->wal) return;
+	
+	if (!wal_Append( names->wal, op, name, freq))
+		fail_log();
+	else if (names->wal->records >= names->checkpointAt)
+	{
+		if (checkpoint_names( names)) names->checkpointAt = CHECKPOINT_INTERVAL;
+		else
+		{
+			fprintf( stderr, "Error: cannot write checkpoint\n");
+			names->checkpointAt = names->wal->records + CHECKPOINT_INTERVAL;
+		}
+	}
+}
+
+// syncs the log, then releases the results of the commands it covers (stdout)
+// so that no add or delete is acknowledged before its record is on disk
+// the program stops if the log cannot be synced (fail_log)
+void commit_results( tNames *names)
+{
+	if (names->wal && !wal_Sync( names->wal)) fail_log();
+	fflush( stdout);
+}
+
+// appends a name from the checkpoint (names come in list order)
+// for wal_Recover function
+void load_name( const char *name, int freq, void *arg)
+{
+	tNames *names = (tNames *)arg;
+	tName *pName = createName( (char *)name, freq);
+	
+	if (!pName || !insertBefore( names->list, endList( names->list), pName)
+		|| !addSNode( names->index, pName, increase_freq))
+		fprintf( stderr, "Error: cannot add [%s]\n", name);
+}
+
+// applies a logged operation (records come in name order, so the list
+// position only moves forward: the whole log tail is one merge pass)
+// for wal_Recover function
+void replay_op( int op, const char *name, int freq, void *arg)
+{
+	tNames *names = (tNames *)arg;
+	LIST *list = names->list;
+	NODE *pos = names->merge ? names->merge : beginList( list);
+	NODE *added;
+	tName key = { (char *)name, freq};
+	tName *pName;
+	void *ptr;
+	int found;
+	
+	while (pos != endList( list) && cmpName( dataAt( pos), &key) < 0)
+		pos = nextNode( list, pos);
+	found = pos != endList( list) && cmpName( dataAt( pos), &key) == 0;
+	
+	if (op == WAL_ADD && found)
+		increase_freq( dataAt( pos), &key);
+	else if (op == WAL_ADD)
+	{
+		pName = createName( key.name, freq);
+		added = pName ? insertBefore( list, pos, pName) : NULL;
+		
+		if (added) pos = added;
+		else if (pName) destroyName( pName);
+		
+		if (!added || !addSNode( names->index, pName, increase_freq))
+			fprintf( stderr, "Error: cannot add [%s]\n", name);
+	}
+	else if (op == WAL_REMOVE && found)
+	{
+		removeSNode( names->index, &key, &ptr);
+		pos = eraseAt( list, pos, &ptr);
+		destroyName( ptr);
+	}
+	names->merge = pos;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// executes one command (except QUIT) on the name lists
+//	arg1	name (S, A, D, R), k (K) or lower bound (N, L)
+//	arg2	freq (A) or upper bound (N, L)
+void run_action( tNames *names, int action, char *arg1, char *arg2)
+{
+	LIST *list = names->list;
+	void *ptr;
+	tName *pName;
+	tName key = { arg1, 0}; // borrowed keys for searching
+	tName key2 = { arg2, 0};
+	
+	switch( action)
+	{
+		case FORWARD_PRINT:
+			if (!traverseList( list, print_name)) fprintf( stderr, "Error: cannot sort list for traversal\n");
+			break;
+		
+		case BACKWARD_PRINT:
+			if (!traverseListR( list, print_name)) fprintf( stderr, "Error: cannot sort list for traversal\n");
+			break;
+		
+		case SEARCH:
+			if (searchList( list, &key, &ptr)) print_name( ptr);
+			else fprintf( stdout, "%s not found\n", arg1);
+			break;
+			
+		case ADD:
+			if (add_name( names, arg1, atoi( arg2)))
+			{
+				log_op( names, WAL_ADD, arg1, atoi( arg2));
+				if (searchList( list, &key, &ptr)) print_name( ptr);
+			}
+			else fprintf( stdout, "cannot add %s\n", arg1);
+			break;
+			
+		case DELETE:
+			if ((pName = delete_name( names, arg1)) != NULL)
+			{
+				log_op( names, WAL_REMOVE, arg1, 0);
+				fprintf( stdout, "(%s, %d) deleted\n", pName->name, pName->freq);
+				destroyName( pName);
+			}
+			else fprintf( stdout, "%s not found\n", arg1);
+			break;
+		
+		case COUNT:
+			fprintf( stdout, "%d\n", countList( list));
+			break;
+		
+		case RANK:
+			if (searchSList( names->index, &key, &ptr))
+				fprintf( stdout, "%s\t%d\n", arg1, rankOf( names->index, &key));
+			else fprintf( stdout, "%s not found\n", arg1);
+			break;
+		
+		case SELECT:
+			if (selectK( names->index, atoi( arg1), &ptr)) print_name( ptr);
+			else fprintf( stdout, "%s out of range\n", arg1);
+			break;
+		
+		case COUNT_RANGE:
+			fprintf( stdout, "%d\n", countRange( names->index, &key, &key2));
+			break;
+		
+		case LIST_RANGE:
+			traverseRange( names->index, &key, &key2, print_name);
+			break;
+	}
+}
+
+// recycles memory of the name lists (the name structures are owned by list)
+// the persistent state is checkpointed first
+void destroy_names( tNames *names)
+{
+	if (names->wal)
+	{
+		if (!checkpoint_names( names)) fprintf( stderr, "Error: cannot write checkpoint\n");
+		wal_Close( names->wal);
+	}
+	destroySList( names->index, no_destroy);
+	destroyList( names->list, destroyName);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// returns monotonic clock in nanoseconds
+static long long now_ns( void)
+{
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts);
+	return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// for qsort function
+static int cmpLatency( const void *p1, const void *p2)
+{
+	long long a = *(const long long *)p1;
+	long long b = *(const long long *)p2;
+	
+	return (a > b) - (a < b);
+}
+
+// appends latency of a command to the statistics
+//	return	0 if overflow
+//			1 if successful
+static int add_latency( tStat *stat, long long ns)
+{
+	if (stat->len == stat->capacity)
+	{
+		int capacity = stat->capacity ? stat->capacity * 2 : 1024;
+		long long *latency = (long long *)realloc( stat->latency, sizeof(long long) * capacity);
+		if (!latency) return 0;
+		
+		stat->latency = latency;
+		stat->capacity = capacity;
+	}
+	stat->latency[stat->len++] = ns;
+	return 1;
+}
+
+// prints per-command counts, throughput and latency percentiles to stderr
+static void print_stat( tStat *stat, long long elapsed)
+{
+	static const char *label[MAX_ACTION + 1] = { "?", "Q", "P", "B", "S", "D", "C", "R", "K", "N", "L", "A"};
+	double sec = elapsed / 1e9;
+	int i;
+	
+	fprintf( stderr, "commands: %d (", stat->len);
+	for (i = FORWARD_PRINT; i <= MAX_ACTION; i++)
+		fprintf( stderr, "%s%s %d", i == FORWARD_PRINT ? "" : ", ", label[i], stat->count[i]);
+	fprintf( stderr, ")\n");
+	if (stat->count[0]) fprintf( stderr, "skipped: %d undefined commands\n", stat->count[0]);
+	
+	fprintf( stderr, "elapsed: %.3f sec, throughput: %.0f ops/sec\n", sec, sec > 0 ? stat->len / sec : 0.0);
+	
+	if (stat->len == 0) return;
+	
+	qsort( stat->latency, stat->len, sizeof(long long), cmpLatency);
+	fprintf( stderr, "latency (us): p50 %.2f, p90 %.2f, p99 %.2f, p99.9 %.2f, max %.2f\n",
+		stat->latency[(int)(stat->len * 0.50)] / 1e3,
+		stat->latency[(int)(stat->len * 0.90)] / 1e3,
+		stat->latency[(int)(stat->len * 0.99)] / 1e3,
+		stat->latency[(int)(stat->len * 0.999)] / 1e3,
+		stat->latency[stat->len - 1] / 1e3);
+}
+
+// reads commands from script and executes them without prompts
+// a command per line: S name, A name freq, D name, C, P, B, R name, K k, N lo hi, L lo hi, Q
+// results are committed in chunks of GROUP_COMMIT commands, and before a
+// listing (P, B, L) whose output may fill the stdout buffer
+//	return	0 if overflow
+//			1 if successful
+int run_batch( tNames *names, FILE *script)
+{
+	char line[MAX_LINE];
+	char arg1[100], arg2[100];
+	tStat stat = { {0}, NULL, 0, 0};
+	long long start, t0;
+	int chunk = 0;
+	int ret = 1;
+	
+	// results go to a fully buffered stdout
+	setvbuf( stdout, NULL, _IOFBF, BATCH_BUFSIZE);
+	
+	start = now_ns();
+	while (fgets( line, MAX_LINE, script) != NULL)
+	{
+		char *p = line;
+		int action;
+		
+		while (isspace( (unsigned char)*p)) p++;
+		if (*p == '\0' || *p == '#') continue; // empty line or comment
+		
+		action = char_to_action( *p);
+		if (action == QUIT) break;
+		
+		if (!action || (action_args( action) && sscanf( p + 1, "%99s %99s", arg1, arg2) < action_args( action)))
+		{
+			stat.count[0]++;
+			continue;
+		}
+		
+		if (chunk == GROUP_COMMIT || action == FORWARD_PRINT || action == BACKWARD_PRINT || action == LIST_RANGE)
+		{
+			commit_results( names);
+			chunk = 0;
+		}
+		
+		t0 = now_ns();
+		run_action( names, action, arg1, arg2);
+		if (!add_latency( &stat, now_ns() - t0))
+		{
+			ret = 0;
+			break;
+		}
+		stat.count[action]++;
+		chunk++;
+	}
+	commit_results( names);
+	
+	print_stat( &stat, now_ns() - start);
+	free( stat.latency);
+	
+	return ret;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int main( int argc, char **argv)
 {
+	tNames names;
 	LIST *list;
+	NODE *pos;
 	
 	char name[100];
+	char name2[100];
 	int freq;
 	
-	tName *pName;
 	int ret;
+	int i;
 	FILE *fp;
+	FILE *script = NULL;
+	char *prefix = NULL;
 	
-	if (argc != 2) {
-		fprintf( stderr, "usage: %s FILE\n", argv[0]);
-		return 1;
-	}
-	
-	fp = fopen( argv[1], "rt");
-	if (!fp)
+	for (i = 1; i + 1 < argc && argv[i][0] == '-'; i += 2)
 	{
-		fprintf( stderr, "Error: cannot open file [%s]\n", argv[1]);
-		return 2;
+		if (strcmp( argv[i], "-b") == 0)
+		{
+			script = fopen( argv[i + 1], "rt");
+			if (!script)
+			{
+				fprintf( stderr, "Error: cannot open file [%s]\n", argv[i + 1]);
+				return 2;
+			}
+		}
+		else if (strcmp( argv[i], "-w") == 0) prefix = argv[i + 1];
+		else break;
+	}
+	if (i >= argc) {
+		fprintf( stderr, "usage: %s [-b SCRIPT] [-w PREFIX] FILE...\n", argv[0]);
+		return 1;
 	}
 	
-	// creates an empty list
+	// creates empty lists
 	list = createList( cmpName);
-	if (!list)
+	names.list = list;
+	names.index = createSList( cmpName);
+	names.wal = NULL;
+	names.merge = NULL;
+	names.checkpointAt = CHECKPOINT_INTERVAL;
+	if (!list || !names.index)
 	{
 		printf( "Cannot create list\n");
 		return 100;
 	}
 	
-	while(fscanf( fp, "%*d\t%s\t%*c\t%d", name, &freq) != EOF)
+	if (prefix)
 	{
-		pName = createName( name, freq);
+		names.wal = wal_Open( prefix, GROUP_COMMIT);
+		if (!names.wal)
+		{
+			printf( "Cannot create log\n");
+			return 100;
+		}
+	}
+	
+	// restarts from the newest checkpoint and the log tail
+	if (names.wal && wal_Exists( names.wal))
+	{
+		if (wal_Recover( names.wal, load_name, replay_op, &names) < 0)
+		{
+			fprintf( stderr, "Error: cannot recover [%s]\n", prefix);
+			return 3;
+		}
+	}
+	else
+	{
+		// each file (e.g. a year or a shard) is loaded into its own list
+		// and merged into the names; freqs of common names are summed
+		for (; i < argc; i++)
+		{
+			LIST *part = createList( cmpName);
+			
+			fp = fopen( argv[i], "rt");
+			if (!fp || !part)
+			{
+				fprintf( stderr, "Error: cannot open file [%s]\n", argv[i]);
+				return 2;
+			}
+			
+			while(fscanf( fp, "%*d\t%s\t%*c\t%d", name, &freq) != EOF)
+			{
+				tName key = { name, freq}; // borrowed key; copied only if new
+				
+				ret = upsertNode( part, &key, copyName, increase_freq, NULL);
+				
+				if (ret == 0) // failure
+				{
+					fprintf( stderr, "Error: cannot add [%s]\n", name);
+				}
+			}
+			
+			fclose( fp);
+			
+			mergeLists( list, part, increase_freq);
+			destroyList( part, destroyName);
+		}
 		
-		ret = addNode( list, pName, increase_freq);
+		// builds rank/range index over the loaded names
+		for (pos = beginList( list); pos != endList( list); pos = nextNode( list, pos))
+			if (!addSNode( names.index, dataAt( pos), increase_freq))
+			{
+				fprintf( stderr, "Error: cannot index [%s]\n", ((tName *)dataAt( pos))->name);
+				return 100;
+			}
 		
-		if (ret == 0 || ret == 2) // failure or duplicated
+		// first checkpoint of the persistent state
+		if (names.wal && (wal_Recover( names.wal, load_name, replay_op, &names) < 0 || !checkpoint_names( &names)))
 		{
-			destroyName( pName);
+			fprintf( stderr, "Error: cannot write checkpoint [%s]\n", prefix);
+			return 3;
 		}
 	}
 	
-	fclose( fp);
+	if (script)
+	{
+		ret = run_batch( &names, script);
+		fclose( script);
+		destroy_names( &names);
+		return ret ? 0 : 100;
+	}
+	
+	// results wait in stdout until their log records are synced
+	if (names.wal) setvbuf( stdout, NULL, _IOFBF, BATCH_BUFSIZE);
 	
-	fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
+	fprintf( stderr, PROMPT);
 	
 	while (1)
 	{
-		void *ptr;
 		int action = get_action();
 		
 		switch( action)
 		{
 			case QUIT:
-				destroyList( list, destroyName);
+				destroy_names( &names);
 				return 0;
 			
-			case FORWARD_PRINT:
-				traverseList( list, print_name);
-				break;
-			
-			case BACKWARD_PRINT:
-				traverseListR( list, print_name);
-				break;
-			
 			case SEARCH:
 				fprintf( stderr, "Input a name to find: ");
 				fscanf( stdin, "%s", name);
+				break;
 				
-				pName = createName( name, 0);
-
-				if (searchList( list, pName, &ptr)) print_name( ptr);
-				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName);
+			case ADD:
+				fprintf( stderr, "Input a name and freq to add: ");
+				fscanf( stdin, "%s %s", name, name2);
 				break;
 				
 			case DELETE:
 				fprintf( stderr, "Input a name to delete: ");
 				fscanf( stdin, "%s", name);
-				
-				pName = createName( name, 0);
-
-				if (removeNode( list, pName, &ptr))
-				{
-					fprintf( stdout, "(%s, %d) deleted\n", ((tName *)ptr)->name, ((tName *)ptr)->freq);
-					destroyName( (tName *)ptr);
-				}
-				else fprintf( stdout, "%s not found\n", name);
-				
-				destroyName( pName);
 				break;
 			
-			case COUNT:
-				fprintf( stdout, "%d\n", countList( list));
+			case RANK:
+				fprintf( stderr, "Input a name to rank: ");
+				fscanf( stdin, "%s", name);
+				break;
+			
+			case SELECT:
+				fprintf( stderr, "Input k: ");
+				fscanf( stdin, "%s", name);
+				break;
+			
+			case COUNT_RANGE:
+			case LIST_RANGE:
+				fprintf( stderr, "Input a name range (from to): ");
+				fscanf( stdin, "%s %s", name, name2);
 				break;
 		}
+		run_action( &names, action, name, name2);
+		commit_results( &names);
 		
-		if (action) fprintf( stderr, "Select Q)uit, P)rint, B)ackward print, S)earch, D)elete, C)ount: ");
+		if (action) fprintf( stderr, PROMPT);
 	}
 	return 0;
 }
@@ -205,3 +711,13 @@ void destroyName( void *pNode){
 	free(((tName *)pNode)->name);
 	free((tName *)pNode);
 }
+
+// Allocates a copy of a (borrowed) name structure
+// for upsertNode function
+void *copyName( const void *pName){
+	return createName( ((tName *)pName)->name, ((tName *)pName)->freq);
+}
+
+// Does nothing; for destroySList function (index does not own names)
+void no_destroy( void *pName){
+}
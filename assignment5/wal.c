@@ -0,0 +1,375 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, realloc, qsort
+#include <string.h> // strlen, strcpy, strcat, memcmp, strcmp, strrchr
+#include <unistd.h> // fsync, truncate, access, close
+#include <fcntl.h> // open
+
+#include "wal.h"
+
+#define CKPT_MAGIC		"NCK1"
+#define IO_BUFSIZE		(1 << 20)	// stdio buffer for sequential I/O
+#define MAX_NAME		65535
+
+// log record read back for replay
+typedef struct
+{
+	unsigned long long	lsn;
+	size_t				offset;	// of the name in the buffer of all names
+	const char			*name;	// set once all names are read
+	int					freq;
+	int					op;
+} LOGREC;
+
+// internal function
+// return	prefix + suffix (caller frees)
+// 			NULL if overflow
+static char *_path( const char *prefix, const char *suffix){
+	char *path = (char *)malloc(strlen(prefix) + strlen(suffix) + 1);
+	if (path == NULL) return NULL;
+
+	strcpy(path, prefix);
+	strcat(path, suffix);
+	return path;
+}
+
+// internal function
+// writes a length-prefixed name and freq
+// return	1 success
+// 			0 I/O error
+static int _writeName( FILE *fp, const char *name, int freq){
+	size_t len = strlen(name);
+	unsigned short len16 = (unsigned short)len;
+
+	if (len > MAX_NAME) return 0;
+
+	return fwrite(&len16, sizeof(len16), 1, fp) == 1
+		&& fwrite(name, 1, len, fp) == len
+		&& fwrite(&freq, sizeof(freq), 1, fp) == 1;
+}
+
+// internal function
+// reads a length-prefixed name (name holds MAX_NAME + 1 chars) and freq
+// return	1 success
+// 			0 end of file or torn record
+static int _readName( FILE *fp, char *name, int *freq){
+	unsigned short len16;
+
+	if (fread(&len16, sizeof(len16), 1, fp) != 1) return 0;
+	if (fread(name, 1, len16, fp) != len16) return 0;
+	name[len16] = '\0';
+
+	return fread(freq, sizeof(*freq), 1, fp) == 1;
+}
+
+// internal function
+// flushes and syncs fp to disk
+static int _sync( FILE *fp){
+	if (fflush(fp) != 0) return 0;
+	return fsync(fileno(fp)) == 0;
+}
+
+// internal function
+// syncs the directory holding path, so a rename in it is on disk
+// return	1 success
+// 			0 I/O error
+static int _syncDir( const char *path){
+	const char *slash = strrchr(path, '/');
+	char *dir;
+	int fd, ok;
+
+	if (slash == NULL) dir = _path(".", "");
+	else if (slash == path) dir = _path("/", "");
+	else{
+		dir = _path(path, "");
+		if (dir != NULL) dir[slash - path] = '\0';
+	}
+	if (dir == NULL) return 0;
+
+	fd = open(dir, O_RDONLY);
+	free(dir);
+	if (fd < 0) return 0;
+
+	ok = fsync(fd) == 0;
+	close(fd);
+	return ok;
+}
+
+// internal function
+// reads the log records after lsn into an array and their names into one buffer
+// good is set to the end of the last whole record (a torn record is dropped)
+// return	number of records (caller frees *records and *names)
+// 			-1 if overflow
+static int _readTail( FILE *fp, unsigned long long lsn, LOGREC **records, char **names, long *good){
+	static char name[MAX_NAME + 1];
+	LOGREC *rec = NULL, *tmpRec;
+	char *buf = NULL, *tmpBuf;
+	size_t used = 0, size = 0, len;
+	int n = 0, capacity = 0, overflow = 0, i;
+
+	while (1){
+		unsigned long long recLsn;
+		unsigned char op;
+		int freq;
+
+		if (fread(&recLsn, sizeof(recLsn), 1, fp) != 1
+			|| fread(&op, 1, 1, fp) != 1
+			|| !_readName(fp, name, &freq))
+			break;
+		*good = ftell(fp);
+
+		if (recLsn <= lsn) continue; // already in checkpoint
+
+		len = strlen(name) + 1;
+		if (n == capacity){
+			capacity = capacity ? capacity * 2 : 1024;
+			tmpRec = (LOGREC *)realloc(rec, sizeof(LOGREC) * capacity);
+			if (tmpRec == NULL){
+				overflow = 1;
+				break;
+			}
+			rec = tmpRec;
+		}
+		if (used + len > size){
+			size = (used + len) * 2;
+			tmpBuf = (char *)realloc(buf, size);
+			if (tmpBuf == NULL){
+				overflow = 1;
+				break;
+			}
+			buf = tmpBuf;
+		}
+		memcpy(buf + used, name, len);
+		rec[n].lsn = recLsn;
+		rec[n].offset = used;
+		rec[n].freq = freq;
+		rec[n].op = op;
+		used += len;
+		n++;
+	}
+	if (overflow){
+		free(rec);
+		free(buf);
+		return -1;
+	}
+
+	for (i = 0; i < n; i++)
+		rec[i].name = buf + rec[i].offset;
+	*records = rec;
+	*names = buf;
+	return n;
+}
+
+// internal function
+// orders log records by name (strcmp, as the name list), then by lsn
+// for qsort function
+static int _cmpRecord( const void *p1, const void *p2){
+	const LOGREC *a = (const LOGREC *)p1;
+	const LOGREC *b = (const LOGREC *)p2;
+	int cmp = strcmp(a->name, b->name);
+
+	if (cmp != 0) return cmp;
+	return (a->lsn > b->lsn) - (a->lsn < b->lsn);
+}
+
+// Allocates WAL for files PREFIX.log and PREFIX.ckpt
+// return	WAL pointer
+// 			NULL if overflow
+WAL *wal_Open( const char *prefix, int groupCommit){
+	WAL *wal = (WAL *)malloc(sizeof(WAL));
+	if (wal == NULL) return NULL;
+
+	wal->log = NULL;
+	wal->ckpt = NULL;
+	wal->logPath = _path(prefix, ".log");
+	wal->ckptPath = _path(prefix, ".ckpt");
+	wal->tmpPath = _path(prefix, ".ckpt.tmp");
+	wal->lsn = 0;
+	wal->pending = 0;
+	wal->records = 0;
+	wal->groupCommit = groupCommit > 0 ? groupCommit : 1;
+
+	if (!wal->logPath || !wal->ckptPath || !wal->tmpPath){
+		wal_Close(wal);
+		return NULL;
+	}
+	return wal;
+}
+
+// Syncs the log and recycles memory
+void wal_Close( WAL *wal){
+	if (wal->log != NULL){
+		_sync(wal->log);
+		fclose(wal->log);
+	}
+	if (wal->ckpt != NULL) fclose(wal->ckpt);
+
+	free(wal->logPath);
+	free(wal->ckptPath);
+	free(wal->tmpPath);
+	free(wal);
+}
+
+// return 1 if a checkpoint or log exists; 0 if not
+int wal_Exists( WAL *wal){
+	return access(wal->ckptPath, F_OK) == 0 || access(wal->logPath, F_OK) == 0;
+}
+
+// Loads the checkpoint (load callback, in list order) and replays the log
+// records after it (replay callback) in name order (strcmp; the records of a
+// name in log order), so they merge into the list in one pass; then opens the
+// log for appending
+// return	number of replayed log records
+// 			-1 if error
+int wal_Recover( WAL *wal,
+	void (*load)(const char *name, int freq, void *arg),
+	void (*replay)(int op, const char *name, int freq, void *arg), void *arg){
+	static char name[MAX_NAME + 1];
+	unsigned long long lsn = 0;
+	unsigned int count, i;
+	char magic[4];
+	int freq;
+	int replayed = 0;
+	long good = 0;
+	LOGREC *records;
+	char *names;
+	FILE *fp;
+
+	// checkpoint
+	if ((fp = fopen(wal->ckptPath, "rb")) != NULL){
+		setvbuf(fp, NULL, _IOFBF, IO_BUFSIZE);
+
+		if (fread(magic, 1, 4, fp) != 4 || memcmp(magic, CKPT_MAGIC, 4) != 0
+			|| fread(&lsn, sizeof(lsn), 1, fp) != 1
+			|| fread(&count, sizeof(count), 1, fp) != 1){
+			fclose(fp);
+			return -1;
+		}
+		for (i = 0; i < count; i++){
+			if (!_readName(fp, name, &freq)){
+				fclose(fp);
+				return -1;
+			}
+			load(name, freq, arg);
+		}
+		fclose(fp);
+	}
+	wal->lsn = lsn;
+
+	// log tail
+	if ((fp = fopen(wal->logPath, "rb")) != NULL){
+		setvbuf(fp, NULL, _IOFBF, IO_BUFSIZE);
+
+		replayed = _readTail(fp, wal->lsn, &records, &names, &good);
+		fclose(fp);
+		if (replayed < 0) return -1;
+
+		// operations on different names commute, so the tail is replayed in
+		// name order: one merge pass over the list instead of a search per record
+		if (replayed > 0) qsort(records, replayed, sizeof(LOGREC), _cmpRecord);
+		for (i = 0; i < (unsigned int)replayed; i++){
+			replay(records[i].op, records[i].name, records[i].freq, arg);
+			if (records[i].lsn > wal->lsn) wal->lsn = records[i].lsn;
+		}
+		free(records);
+		free(names);
+
+		// drops a torn record at the end
+		if (truncate(wal->logPath, good) != 0) return -1;
+	}
+	wal->records = replayed;
+
+	wal->log = fopen(wal->logPath, "ab");
+	if (wal->log == NULL) return -1;
+
+	return replayed;
+}
+
+// Appends an operation (WAL_ADD or WAL_REMOVE) to the log
+// the log is synced every groupCommit records; callers sync (wal_Sync) before
+// they acknowledge the operation
+// return	1 success
+// 			0 I/O error
+int wal_Append( WAL *wal, int op, const char *name, int freq){
+	unsigned long long lsn = wal->lsn + 1;
+	unsigned char op8 = (unsigned char)op;
+
+	if (wal->log == NULL) return 0;
+
+	if (fwrite(&lsn, sizeof(lsn), 1, wal->log) != 1
+		|| fwrite(&op8, 1, 1, wal->log) != 1
+		|| !_writeName(wal->log, name, freq))
+		return 0;
+
+	wal->lsn = lsn;
+	wal->records++;
+
+	if (++wal->pending >= wal->groupCommit)
+		return wal_Sync(wal);
+	return 1;
+}
+
+// Flushes and syncs pending log records
+// return	1 success
+// 			0 I/O error
+int wal_Sync( WAL *wal){
+	if (wal->log == NULL || wal->pending == 0) return 1;
+
+	wal->pending = 0;
+	return _sync(wal->log);
+}
+
+// Starts a checkpoint of count records
+// return	1 success
+// 			0 I/O error
+int wal_CheckpointBegin( WAL *wal, int count){
+	unsigned int count32 = (unsigned int)count;
+
+	wal->ckpt = fopen(wal->tmpPath, "wb");
+	if (wal->ckpt == NULL) return 0;
+	setvbuf(wal->ckpt, NULL, _IOFBF, IO_BUFSIZE);
+
+	return fwrite(CKPT_MAGIC, 1, 4, wal->ckpt) == 4
+		&& fwrite(&wal->lsn, sizeof(wal->lsn), 1, wal->ckpt) == 1
+		&& fwrite(&count32, sizeof(count32), 1, wal->ckpt) == 1;
+}
+
+// Writes one record of the checkpoint (in list order)
+// return	1 success
+// 			0 I/O error
+int wal_CheckpointWrite( WAL *wal, const char *name, int freq){
+	return _writeName(wal->ckpt, name, freq);
+}
+
+// Syncs and installs the checkpoint, then truncates the log
+// (the checkpoint is abandoned if it cannot be installed)
+// return	1 success
+// 			0 I/O error
+int wal_CheckpointEnd( WAL *wal){
+	int ok = _sync(wal->ckpt);
+
+	ok = fclose(wal->ckpt) == 0 && ok;
+	wal->ckpt = NULL;
+	if (!ok || rename(wal->tmpPath, wal->ckptPath) != 0){
+		wal_CheckpointAbort(wal);
+		return 0;
+	}
+
+	// the rename must be on disk before the log is truncated
+	if (!_syncDir(wal->ckptPath)) return 0;
+
+	// records up to lsn are in the checkpoint now
+	if (wal->log != NULL) fclose(wal->log);
+	wal->log = fopen(wal->logPath, "wb");
+	if (wal->log == NULL) return 0;
+
+	wal->pending = 0;
+	wal->records = 0;
+	return 1;
+}
+
+// Abandons the checkpoint being written and removes its temporary file
+void wal_CheckpointAbort( WAL *wal){
+	if (wal->ckpt != NULL) fclose(wal->ckpt);
+	wal->ckpt = NULL;
+	remove(wal->tmpPath);
+}
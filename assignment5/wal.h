@@ -0,0 +1,88 @@
+#include <stdio.h>
+
+////////////////////////////////////////////////////////////////////////////////
+// Write-ahead log and checkpoint for a name list
+//
+// PREFIX.ckpt	binary snapshot of (name, freq) in list order
+// PREFIX.log	append-only log of add/remove operations after the snapshot
+//
+// Every log record carries a sequence number (lsn) and the checkpoint stores
+// the lsn it includes, so replay never applies an operation twice even if the
+// log was not truncated after the last checkpoint.
+// Log records are synced to disk in groups (group commit); a caller syncs
+// (wal_Sync) before it acknowledges an operation, so a group only holds records
+// not acknowledged yet. A torn record at the end of the log is dropped on
+// recovery.
+
+#define WAL_ADD		'A'
+#define WAL_REMOVE	'R'
+
+////////////////////////////////////////////////////////////////////////////////
+// WAL type definition
+typedef struct
+{
+	FILE				*log;			// operation log (append)
+	FILE				*ckpt;			// checkpoint being written
+	char				*logPath;
+	char				*ckptPath;
+	char				*tmpPath;		// checkpoint is renamed from here when complete
+	unsigned long long	lsn;			// sequence number of the last record
+	int					pending;		// records written but not synced
+	int					records;		// records since the last checkpoint
+	int					groupCommit;	// records per fsync
+} WAL;
+
+////////////////////////////////////////////////////////////////////////////////
+// function declarations
+
+// Allocates WAL for files PREFIX.log and PREFIX.ckpt
+// return	WAL pointer
+// 			NULL if overflow
+WAL *wal_Open( const char *prefix, int groupCommit);
+
+// Syncs the log and recycles memory
+void wal_Close( WAL *wal);
+
+// return 1 if a checkpoint or log exists; 0 if not
+int wal_Exists( WAL *wal);
+
+// Loads the checkpoint (load callback, in list order) and replays the log
+// records after it (replay callback) in name order (strcmp; the records of a
+// name in log order), so they merge into the list in one pass; then opens the
+// log for appending
+// return	number of replayed log records
+// 			-1 if error
+int wal_Recover( WAL *wal,
+	void (*load)(const char *name, int freq, void *arg),
+	void (*replay)(int op, const char *name, int freq, void *arg), void *arg);
+
+// Appends an operation (WAL_ADD or WAL_REMOVE) to the log
+// the log is synced every groupCommit records; callers sync (wal_Sync) before
+// they acknowledge the operation
+// return	1 success
+// 			0 I/O error
+int wal_Append( WAL *wal, int op, const char *name, int freq);
+
+// Flushes and syncs pending log records
+// return	1 success
+// 			0 I/O error
+int wal_Sync( WAL *wal);
+
+// Starts a checkpoint of count records
+// return	1 success
+// 			0 I/O error
+int wal_CheckpointBegin( WAL *wal, int count);
+
+// Writes one record of the checkpoint (in list order)
+// return	1 success
+// 			0 I/O error
+int wal_CheckpointWrite( WAL *wal, const char *name, int freq);
+
+// Syncs and installs the checkpoint, then truncates the log
+// (the checkpoint is abandoned if it cannot be installed)
+// return	1 success
+// 			0 I/O error
+int wal_CheckpointEnd( WAL *wal);
+
+// Abandons the checkpoint being written and removes its temporary file
+void wal_CheckpointAbort( WAL *wal);
@@ -0,0 +1,509 @@
+#include <stdio.h>
+#include <stdlib.h> // aligned_alloc, free
+#include <string.h> // memcpy, memmove
+
+#ifdef __SSE2__
+#include <emmintrin.h> // SSE2 intrinsics
+#endif
+
+#include "adt_bptree.h"
+
+#define CACHE_LINE	64
+
+// node fields by index (pTree must be in scope)
+#define KEYS(id)	(pTree->nodes[id].keys)
+#define LINK(id)	(pTree->nodes[id].link)
+#define NKEYS(id)	(pTree->nodes[id].keys[BPT_MAX_KEYS])
+#define NEXT(id)	(pTree->nodes[id].link[BPT_MAX_KEYS])
+
+/* internal function
+	return	number of keys[0] ~ keys[n - 1] less than key (orEqual = 0)
+			or not greater than key (orEqual = 1)
+	keys are sorted, so it is the position of key; SSE2 compares all slots at
+	once and counts the bits of the lanes below n, without a branch per key
+*/
+static int _rank(const int* keys, int n, int key, int orEqual) {
+#ifdef __SSE2__
+	__m128i k = _mm_set1_epi32(key);
+	__m128i v;
+	unsigned int mask = 0;
+	int i;
+
+	for (i = 0; i < BPT_SLOTS; i += 4) {
+		v = _mm_load_si128((const __m128i*)(keys + i));
+		// orEqual: lanes with keys[i] > key (complemented below)
+		v = orEqual ? _mm_cmpgt_epi32(v, k) : _mm_cmpgt_epi32(k, v);
+		mask |= (unsigned int)_mm_movemask_ps(_mm_castsi128_ps(v)) << i;
+	}
+	if (orEqual) mask = ~mask;
+
+	return __builtin_popcount(mask & ((1U << n) - 1));
+#else
+	int i = 0;
+
+	if (orEqual)
+		while (i < n && keys[i] <= key) i++;
+	else
+		while (i < n && keys[i] < key) i++;
+	return i;
+#endif
+}
+
+/* internal function
+	grows the pool so that need more nodes fit without another allocation
+	(aligned_alloc keeps every node on its own pair of cache lines)
+	return	1 success
+			0 overflow
+*/
+static int _reserve(BPTREE* pTree, BPTID need) {
+	BPTID capacity = pTree->capacity;
+	BPNODE* nodes;
+
+	while (capacity - pTree->used < need) {
+		if (capacity * 2 <= capacity) return 0; // 32-bit index overflow
+		capacity *= 2;
+	}
+	if (capacity == pTree->capacity) return 1;
+
+	nodes = (BPNODE*)aligned_alloc(CACHE_LINE, sizeof(BPNODE) * capacity);
+	if (nodes == NULL) return 0;
+
+	memcpy(nodes, pTree->nodes, sizeof(BPNODE) * pTree->used);
+	free(pTree->nodes);
+	pTree->nodes = nodes;
+	pTree->capacity = capacity;
+	return 1;
+}
+
+/* internal function
+	takes an empty node from the free list or the end of the pool
+	return	index of the node
+			BPT_NIL if overflow
+*/
+static BPTID _makeNode(BPTREE* pTree) {
+	BPTID id;
+
+	if (pTree->freeList != BPT_NIL) {
+		id = pTree->freeList;
+		pTree->freeList = LINK(id)[0];
+	}
+	else {
+		if (!_reserve(pTree, 1)) return BPT_NIL;
+		id = pTree->used++;
+	}
+
+	NKEYS(id) = 0;
+	NEXT(id) = BPT_NIL;
+	return id;
+}
+
+/* internal function
+	returns a node to the free list
+*/
+static void _freeNode(BPTREE* pTree, BPTID id) {
+	LINK(id)[0] = pTree->freeList;
+	pTree->freeList = id;
+}
+
+/* internal function
+	descends from root to the leaf where key belongs, keeping the inner nodes
+	and the child positions taken in path and index (if not NULL)
+	return	index of the leaf
+*/
+static BPTID _findLeaf(BPTREE* pTree, int key, BPTID* path, int* index) {
+	BPTID cur = pTree->root;
+	int level, i;
+
+	for (level = 0; level < pTree->height - 1; level++) {
+		i = _rank(KEYS(cur), NKEYS(cur), key, 1);
+		if (path != NULL) {
+			path[level] = cur;
+			index[level] = i;
+		}
+		cur = LINK(cur)[i];
+	}
+	return cur;
+}
+
+/* internal function
+	inserts key (and its link: a count in a leaf, the right child in an inner node)
+	at pos of a node that is not full
+*/
+static void _insertAt(BPTREE* pTree, BPTID id, int pos, int key, BPTID link, int isLeaf) {
+	int n = NKEYS(id);
+	int l = isLeaf ? pos : pos + 1;
+
+	memmove(&KEYS(id)[pos + 1], &KEYS(id)[pos], sizeof(int) * (n - pos));
+	memmove(&LINK(id)[l + 1], &LINK(id)[l], sizeof(BPTID) * (n - pos));
+	KEYS(id)[pos] = key;
+	LINK(id)[l] = link;
+	NKEYS(id) = n + 1;
+}
+
+/* internal function
+	removes the key at pos of a node (and its count in a leaf, the child right
+	of it in an inner node)
+*/
+static void _removeAt(BPTREE* pTree, BPTID id, int pos, int isLeaf) {
+	int n = NKEYS(id);
+	int l = isLeaf ? pos : pos + 1;
+
+	memmove(&KEYS(id)[pos], &KEYS(id)[pos + 1], sizeof(int) * (n - pos - 1));
+	memmove(&LINK(id)[l], &LINK(id)[l + 1], sizeof(BPTID) * (n - pos - 1));
+	NKEYS(id) = n - 1;
+}
+
+/* internal function
+	splits a full node while inserting key (and link) at pos; the upper half
+	moves to the new node right
+	edge is 1 if the node is on the last (or first) path of the tree; a key
+	appended there (or prepended) leaves the other side full instead of half,
+	so that sorted input does not leave a trail of half-empty nodes
+	return	separator for the parent (first key of a leaf, or the middle key
+			that leaves an inner node)
+*/
+static int _split(BPTREE* pTree, BPTID id, BPTID right, int pos, int key, BPTID link, int isLeaf, int edge) {
+	int keys[BPT_SLOTS + 1];
+	BPTID links[BPT_SLOTS + 1];
+	int n = NKEYS(id);
+	int l = isLeaf ? pos : pos + 1;
+	int nl = isLeaf ? n : n + 1; // links in use
+	int half = (n + 1) / 2;
+	int up;
+
+	if (edge && pos == n) half = isLeaf ? n : n - 1;
+	else if (edge && pos == 0) half = 1;
+
+	memcpy(keys, KEYS(id), sizeof(int) * pos);
+	keys[pos] = key;
+	memcpy(keys + pos + 1, KEYS(id) + pos, sizeof(int) * (n - pos));
+	memcpy(links, LINK(id), sizeof(BPTID) * l);
+	links[l] = link;
+	memcpy(links + l + 1, LINK(id) + l, sizeof(BPTID) * (nl - l));
+
+	// n + 1 keys: half stay, the rest (but the separator of an inner node) move right
+	memcpy(KEYS(id), keys, sizeof(int) * half);
+	NKEYS(id) = half;
+
+	if (isLeaf) {
+		memcpy(LINK(id), links, sizeof(BPTID) * half);
+		memcpy(KEYS(right), keys + half, sizeof(int) * (n + 1 - half));
+		memcpy(LINK(right), links + half, sizeof(BPTID) * (n + 1 - half));
+		NKEYS(right) = n + 1 - half;
+
+		NEXT(right) = NEXT(id);
+		NEXT(id) = right;
+		return KEYS(right)[0];
+	}
+
+	memcpy(LINK(id), links, sizeof(BPTID) * (half + 1));
+	up = keys[half];
+	memcpy(KEYS(right), keys + half + 1, sizeof(int) * (n - half));
+	memcpy(LINK(right), links + half + 1, sizeof(BPTID) * (n - half + 1));
+	NKEYS(right) = n - half;
+	return up;
+}
+
+/* internal function
+	fixes an underflowed node cur (child ci of parent) by borrowing a key from a
+	sibling, or merging with it when the sibling has no key to spare
+	return	1 merged (parent lost a key)
+			0 borrowed
+*/
+static int _rebalance(BPTREE* pTree, BPTID parent, int ci, BPTID cur, int isLeaf) {
+	BPTID left, right;
+	int j, n, nl, nr;
+
+	if (ci > 0) {
+		left = LINK(parent)[ci - 1];
+		right = cur;
+		j = ci - 1;
+	}
+	else {
+		left = cur;
+		right = LINK(parent)[1];
+		j = 0;
+	}
+	nl = NKEYS(left);
+	nr = NKEYS(right);
+
+	// borrows the last key of the left sibling
+	if (left != cur && nl > BPT_MIN_KEYS) {
+		if (isLeaf) {
+			_insertAt(pTree, cur, 0, KEYS(left)[nl - 1], LINK(left)[nl - 1], 1);
+			KEYS(parent)[j] = KEYS(cur)[0];
+		}
+		else {
+			n = NKEYS(cur);
+			memmove(&KEYS(cur)[1], &KEYS(cur)[0], sizeof(int) * n);
+			memmove(&LINK(cur)[1], &LINK(cur)[0], sizeof(BPTID) * (n + 1));
+			KEYS(cur)[0] = KEYS(parent)[j];
+			LINK(cur)[0] = LINK(left)[nl];
+			NKEYS(cur) = n + 1;
+			KEYS(parent)[j] = KEYS(left)[nl - 1];
+		}
+		NKEYS(left) = nl - 1;
+		return 0;
+	}
+
+	// borrows the first key of the right sibling
+	if (right != cur && nr > BPT_MIN_KEYS) {
+		n = NKEYS(cur);
+		if (isLeaf) {
+			KEYS(cur)[n] = KEYS(right)[0];
+			LINK(cur)[n] = LINK(right)[0];
+			NKEYS(cur) = n + 1;
+			_removeAt(pTree, right, 0, 1);
+			KEYS(parent)[j] = KEYS(right)[0];
+		}
+		else {
+			KEYS(cur)[n] = KEYS(parent)[j];
+			LINK(cur)[n + 1] = LINK(right)[0];
+			NKEYS(cur) = n + 1;
+			KEYS(parent)[j] = KEYS(right)[0];
+			memmove(&KEYS(right)[0], &KEYS(right)[1], sizeof(int) * (nr - 1));
+			memmove(&LINK(right)[0], &LINK(right)[1], sizeof(BPTID) * nr);
+			NKEYS(right) = nr - 1;
+		}
+		return 0;
+	}
+
+	// merges right into left (both at most half full)
+	if (isLeaf) {
+		memcpy(&KEYS(left)[nl], KEYS(right), sizeof(int) * nr);
+		memcpy(&LINK(left)[nl], LINK(right), sizeof(BPTID) * nr);
+		NKEYS(left) = nl + nr;
+		NEXT(left) = NEXT(right);
+	}
+	else {
+		KEYS(left)[nl] = KEYS(parent)[j];
+		memcpy(&KEYS(left)[nl + 1], KEYS(right), sizeof(int) * nr);
+		memcpy(&LINK(left)[nl + 1], LINK(right), sizeof(BPTID) * (nr + 1));
+		NKEYS(left) = nl + 1 + nr;
+	}
+	_removeAt(pTree, parent, j, 0);
+	_freeNode(pTree, right);
+	return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Allocates dynamic memory for a tree head node and returns its address to caller
+	return	head node pointer
+			NULL if overflow
+*/
+BPTREE* BPT_Create(void) {
+	BPTREE* pTree = (BPTREE*)malloc(sizeof(BPTREE));
+	if (pTree == NULL) return NULL;
+
+	pTree->nodes = (BPNODE*)aligned_alloc(CACHE_LINE, sizeof(BPNODE) * BPT_POOL_INIT);
+	if (pTree->nodes == NULL) {
+		free(pTree);
+		return NULL;
+	}
+	pTree->capacity = BPT_POOL_INIT;
+	pTree->used = 1; // skips BPT_NIL
+	pTree->freeList = BPT_NIL;
+
+	pTree->root = BPT_NIL;
+	pTree->first = BPT_NIL;
+	pTree->height = 0;
+	pTree->count = 0;
+	return pTree;
+}
+
+/* Deletes all data in tree and recycles memory (the pool is released at once)
+*/
+void BPT_Destroy(BPTREE* pTree) {
+	free(pTree->nodes);
+	free(pTree);
+}
+
+/* Inserts new data into the tree (a duplicate increments the count of its key)
+	return	1 success
+			0 overflow
+*/
+int BPT_Insert(BPTREE* pTree, int data) {
+	BPTID path[BPT_MAX_DEPTH];
+	int index[BPT_MAX_DEPTH];
+	BPTID leaf, right, node;
+	int pos, sep, level, edge;
+
+	if (pTree->root == BPT_NIL) {
+		pTree->root = pTree->first = _makeNode(pTree);
+		if (pTree->root == BPT_NIL) return 0;
+		pTree->height = 1;
+	}
+
+	leaf = _findLeaf(pTree, data, path, index);
+	pos = _rank(KEYS(leaf), NKEYS(leaf), data, 0);
+
+	if (pos < NKEYS(leaf) && KEYS(leaf)[pos] == data)
+		LINK(leaf)[pos]++;
+	else if (NKEYS(leaf) < BPT_MAX_KEYS)
+		_insertAt(pTree, leaf, pos, data, 1, 1);
+	else {
+		// a split may climb to the root: takes all the nodes it can need up front,
+		// so that the tree is never left half split
+		if (!_reserve(pTree, pTree->height + 1)) return 0;
+
+		// the last leaf gets a new largest key, or the first a new smallest one
+		edge = (pos == BPT_MAX_KEYS && NEXT(leaf) == BPT_NIL) || (pos == 0 && leaf == pTree->first);
+
+		right = _makeNode(pTree);
+		sep = _split(pTree, leaf, right, pos, data, 1, 1, edge);
+
+		for (level = pTree->height - 2; level >= 0; level--) {
+			node = path[level];
+			if (NKEYS(node) < BPT_MAX_KEYS) {
+				_insertAt(pTree, node, index[level], sep, right, 0);
+				break;
+			}
+
+			// index[level] is where the separator of the split child goes
+			pos = index[level];
+			node = _makeNode(pTree);
+			sep = _split(pTree, path[level], node, pos, sep, right, 0, edge);
+			right = node;
+		}
+
+		// the root split: a new root on top
+		if (level < 0) {
+			node = _makeNode(pTree);
+			KEYS(node)[0] = sep;
+			LINK(node)[0] = pTree->root;
+			LINK(node)[1] = right;
+			NKEYS(node) = 1;
+			pTree->root = node;
+			pTree->height++;
+		}
+	}
+
+	pTree->count++;
+	return 1;
+}
+
+/* Deletes an occurrence of dltKey from the tree
+	return	1 success
+			0 not found
+*/
+int BPT_Delete(BPTREE* pTree, int dltKey) {
+	BPTID path[BPT_MAX_DEPTH];
+	int index[BPT_MAX_DEPTH];
+	BPTID leaf, cur;
+	int pos, level;
+
+	if (pTree->root == BPT_NIL) return 0;
+
+	leaf = _findLeaf(pTree, dltKey, path, index);
+	pos = _rank(KEYS(leaf), NKEYS(leaf), dltKey, 0);
+	if (pos == NKEYS(leaf) || KEYS(leaf)[pos] != dltKey) return 0;
+
+	pTree->count--;
+	if (LINK(leaf)[pos] > 1) {
+		LINK(leaf)[pos]--;
+		return 1;
+	}
+	_removeAt(pTree, leaf, pos, 1);
+
+	// a separator may now be less than the first key on its right; that is
+	// still a valid bound, so only underflows need fixing
+	cur = leaf;
+	for (level = pTree->height - 1; level > 0 && NKEYS(cur) < BPT_MIN_KEYS; level--) {
+		if (!_rebalance(pTree, path[level - 1], index[level - 1], cur, level == pTree->height - 1))
+			break;
+		cur = path[level - 1];
+	}
+
+	// the root lost its last separator (or the last key)
+	cur = pTree->root;
+	if (NKEYS(cur) == 0) {
+		if (pTree->height > 1) {
+			pTree->root = LINK(cur)[0];
+			pTree->height--;
+		}
+		else {
+			pTree->root = pTree->first = BPT_NIL;
+			pTree->height = 0;
+		}
+		_freeNode(pTree, cur);
+	}
+	return 1;
+}
+
+/* Retrieve tree for the leaf slot containing the requested key
+	return	address of the key in its leaf
+			(valid until the next insertion or deletion)
+			NULL not found
+*/
+int* BPT_Retrieve(BPTREE* pTree, int key) {
+	BPTID leaf;
+	int pos;
+
+	if (pTree->root == BPT_NIL) return NULL;
+
+	leaf = _findLeaf(pTree, key, NULL, NULL);
+	pos = _rank(KEYS(leaf), NKEYS(leaf), key, 0);
+
+	if (pos < NKEYS(leaf) && KEYS(leaf)[pos] == key) return &KEYS(leaf)[pos];
+	else return NULL;
+}
+
+/* prints tree in order by walking the linked leaves (each occurrence of data)
+*/
+void BPT_Traverse(BPTREE* pTree) {
+	BPTID leaf;
+	BPTID c;
+	int i;
+
+	for (leaf = pTree->first; leaf != BPT_NIL; leaf = NEXT(leaf))
+		for (i = 0; i < NKEYS(leaf); i++)
+			for (c = 0; c < LINK(leaf)[i]; c++)
+				printf("%d ", KEYS(leaf)[i]);
+}
+
+/* visits data in [lo, hi] in order (each occurrence)
+	one descent to the first leaf, then a sequential scan of the linked leaves
+*/
+void BPT_RangeVisit(BPTREE* pTree, int lo, int hi, void (*callback)(int data)) {
+	BPTID leaf;
+	BPTID c;
+	int i;
+
+	if (pTree->root == BPT_NIL || lo > hi) return;
+
+	leaf = _findLeaf(pTree, lo, NULL, NULL);
+	i = _rank(KEYS(leaf), NKEYS(leaf), lo, 0);
+
+	for (; leaf != BPT_NIL; leaf = NEXT(leaf), i = 0) {
+		for (; i < NKEYS(leaf); i++) {
+			if (KEYS(leaf)[i] > hi) return;
+			for (c = 0; c < LINK(leaf)[i]; c++)
+				(*callback)(KEYS(leaf)[i]);
+		}
+	}
+}
+
+/*
+	return 1 if the tree is empty; 0 if not
+*/
+int BPT_Empty(BPTREE* pTree) {
+	return pTree->root == BPT_NIL;
+}
+
+/* return number of data in the tree (counting every occurrence)
+*/
+int BPT_Count(BPTREE* pTree) {
+	return pTree->count;
+}
+
+/* return height of the tree (0 for an empty tree)
+*/
+int BPT_Height(BPTREE* pTree) {
+	return pTree->height;
+}
+
+/* return bytes allocated for the tree (head and node pool)
+*/
+size_t BPT_Bytes(BPTREE* pTree) {
+	return sizeof(BPTREE) + sizeof(BPNODE) * (size_t)pTree->capacity;
+}
@@ -0,0 +1,103 @@
+#include <stddef.h> // size_t
+
+////////////////////////////////////////////////////////////////////////////////
+// B+-tree of int keys with nodes of two cache lines
+// keys live only in leaves, with an occurrence count each (duplicates share a
+// slot); inner nodes hold separators to route a search, and leaves are linked
+// in key order, so a range scan reads leaves one after another
+
+#define BPT_SLOTS		16				// slots per node (one cache line of keys)
+#define BPT_MAX_KEYS	(BPT_SLOTS - 1)	// keys per node (the last slot holds the number of keys)
+#define BPT_MIN_KEYS	(BPT_MAX_KEYS / 2)	// keys per node except root after a deletion
+#define BPT_MAX_DEPTH	16				// deeper than any tree of 2^32 nodes
+
+// first capacity of the node pool
+#define BPT_POOL_INIT	64
+
+////////////////////////////////////////////////////////////////////////////////
+// BPTREE type definition
+// nodes live in one growable array (node pool) aligned to cache lines and link
+// each other by 32-bit index; index 0 (BPT_NIL) is never used
+typedef unsigned int BPTID;
+
+#define BPT_NIL		0
+
+typedef struct
+{
+	// keys[0] ~ keys[n - 1] in ascending order, keys[BPT_MAX_KEYS] = n
+	int		keys[BPT_SLOTS];
+
+	// inner: link[0] ~ link[n] are children (link[i] holds keys < keys[i])
+	// leaf: link[0] ~ link[n - 1] are occurrence counts, link[BPT_MAX_KEYS] the next leaf
+	BPTID	link[BPT_SLOTS];
+} BPNODE;
+
+typedef struct
+{
+	BPNODE*	nodes;		// node pool (nodes[BPT_NIL] is unused)
+	BPTID	capacity;	// allocated nodes in pool
+	BPTID	used;		// nodes[1] ~ nodes[used - 1] have been handed out
+	BPTID	freeList;	// released nodes, linked through link[0]
+	BPTID	root;		// BPT_NIL if the tree is empty
+	BPTID	first;		// leftmost leaf
+	int		height;		// levels (leaves are at level height - 1)
+	int		count;		// number of data (counting every occurrence)
+} BPTREE;
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Allocates dynamic memory for a tree head node and returns its address to caller
+	return	head node pointer
+			NULL if overflow
+*/
+BPTREE* BPT_Create(void);
+
+/* Deletes all data in tree and recycles memory (the pool is released at once)
+*/
+void BPT_Destroy(BPTREE* pTree);
+
+/* Inserts new data into the tree (a duplicate increments the count of its key)
+	return	1 success
+			0 overflow
+*/
+int BPT_Insert(BPTREE* pTree, int data);
+
+/* Deletes an occurrence of dltKey from the tree
+	return	1 success
+			0 not found
+*/
+int BPT_Delete(BPTREE* pTree, int dltKey);
+
+/* Retrieve tree for the leaf slot containing the requested key
+	return	address of the key in its leaf
+			(valid until the next insertion or deletion)
+			NULL not found
+*/
+int* BPT_Retrieve(BPTREE* pTree, int key);
+
+/* prints tree in order by walking the linked leaves (each occurrence of data)
+*/
+void BPT_Traverse(BPTREE* pTree);
+
+/* visits data in [lo, hi] in order (each occurrence)
+	one descent to the first leaf, then a sequential scan of the linked leaves
+*/
+void BPT_RangeVisit(BPTREE* pTree, int lo, int hi, void (*callback)(int data));
+
+/*
+	return 1 if the tree is empty; 0 if not
+*/
+int BPT_Empty(BPTREE* pTree);
+
+/* return number of data in the tree (counting every occurrence)
+*/
+int BPT_Count(BPTREE* pTree);
+
+/* return height of the tree (0 for an empty tree)
+*/
+int BPT_Height(BPTREE* pTree);
+
+/* return bytes allocated for the tree (head and node pool)
+*/
+size_t BPT_Bytes(BPTREE* pTree);
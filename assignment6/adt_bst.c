@@ -0,0 +1,1553 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, realloc, rand
+#include <string.h> // memcpy, memset
+#include <limits.h> // INT_MIN, INT_MAX
+
+#include "adt_bst.h"
+
+// deepest insertion path of a scapegoat tree
+// (log(2^31) / log(1 / BST_ALPHA_MAX) < SG_MAX_DEPTH)
+#define SG_MAX_DEPTH	512
+
+// node fields by index (pTree must be in scope)
+#define LEFT(id)	(pTree->pool->nodes[id].left)
+#define RIGHT(id)	(pTree->pool->nodes[id].right)
+#define DATA(id)	(pTree->pool->nodes[id].data)
+#define SIZE(id)	(pTree->pool->nodes[id].size)
+#define COUNT(id)	(pTree->pool->nodes[id].count)
+
+/* internal function
+	takes a node from the free list, the lazy list or the end of the pool (the pool
+	grows by doubling; pages past the used part are not touched, so they stay out
+	of resident memory)
+	return	index of a new node with data
+			BST_NIL if overflow
+*/
+static NODEID _makeNode(TREE* pTree, int data) {
+	NODEPOOL* pool = pTree->pool;
+	NODEID id;
+
+	if (pool->freeList != BST_NIL) {
+		id = pool->freeList;
+		pool->freeList = LEFT(id);
+	}
+	else if (pool->lazyList != BST_NIL) {
+		// a released subtree: its root is reused, its children wait in its place
+		id = pool->lazyList;
+		pool->lazyList = (NODEID)DATA(id);
+		if (LEFT(id) != BST_NIL) {
+			DATA(LEFT(id)) = (int)pool->lazyList;
+			pool->lazyList = LEFT(id);
+		}
+		if (RIGHT(id) != BST_NIL) {
+			DATA(RIGHT(id)) = (int)pool->lazyList;
+			pool->lazyList = RIGHT(id);
+		}
+	}
+	else {
+		if (pool->used == pool->capacity) {
+			NODEID capacity = pool->capacity * 2;
+			NODE* nodes;
+
+			if (capacity <= pool->capacity) return BST_NIL; // 32-bit index overflow
+
+			nodes = (NODE*)realloc(pool->nodes, sizeof(NODE) * capacity);
+			if (nodes == NULL) return BST_NIL;
+
+			pool->nodes = nodes;
+			pool->capacity = capacity;
+		}
+		id = pool->used++;
+	}
+
+	DATA(id) = data;
+	LEFT(id) = BST_NIL;
+	RIGHT(id) = BST_NIL;
+	SIZE(id) = 1;
+	COUNT(id) = 1;
+
+	return id;
+}
+
+/* internal function
+	returns a node to the free list
+*/
+static void _freeNode(TREE* pTree, NODEID id) {
+	LEFT(id) = pTree->pool->freeList;
+	pTree->pool->freeList = id;
+	pTree->count--;
+}
+
+/* internal function
+	returns a whole subtree of n nodes to the lazy list in O(1)
+*/
+static void _freeSubtree(TREE* pTree, NODEID root, int n) {
+	if (root == BST_NIL) return;
+
+	DATA(root) = (int)pTree->pool->lazyList;
+	pTree->pool->lazyList = root;
+	pTree->count -= n;
+}
+
+/* internal function
+	allocates an empty node pool
+	return	pool pointer
+			NULL if overflow
+*/
+static NODEPOOL* _makePool(NODEID capacity) {
+	NODEPOOL* pool = (NODEPOOL*)malloc(sizeof(NODEPOOL));
+	if (pool == NULL) return NULL;
+
+	pool->nodes = (NODE*)malloc(sizeof(NODE) * capacity);
+	if (pool->nodes == NULL) {
+		free(pool);
+		return NULL;
+	}
+	pool->capacity = capacity;
+	pool->used = 1; // skips BST_NIL
+	pool->freeList = BST_NIL;
+	pool->lazyList = BST_NIL;
+	pool->refs = 1;
+	return pool;
+}
+
+/* internal function
+	drops a tree's reference to its pool; the last one releases it
+*/
+static void _releasePool(NODEPOOL* pool) {
+	if (--pool->refs > 0) return;
+
+	free(pool->nodes);
+	free(pool);
+}
+
+/* internal function
+	treap priority of a node (max-heap order); a hash of the node index with
+	the tree seed, so that nodes need no priority field and equal keys still get
+	independent priorities
+*/
+static unsigned int _priority(TREE* pTree, NODEID id) {
+	unsigned int x = id ^ pTree->seed;
+
+	x ^= x >> 16;
+	x *= 0x7feb352dU;
+	x ^= x >> 15;
+	x *= 0x846ca68bU;
+	x ^= x >> 16;
+	return x;
+}
+
+/* internal function
+	return	number of data in the subtree
+*/
+static int _size(TREE* pTree, NODEID root) {
+	return (root == BST_NIL) ? 0 : SIZE(root);
+}
+
+/* internal function
+	recomputes size of root from its children
+*/
+static void _update(TREE* pTree, NODEID root) {
+	SIZE(root) = _size(pTree, LEFT(root)) + COUNT(root) + _size(pTree, RIGHT(root));
+}
+
+/* internal function
+	return	number of nodes in the subtree (differs from size in multiset mode)
+*/
+static int _nodes(TREE* pTree, NODEID root) {
+	if (!pTree->multiset) return _size(pTree, root);
+	if (root == BST_NIL) return 0;
+
+	return _nodes(pTree, LEFT(root)) + 1 + _nodes(pTree, RIGHT(root));
+}
+
+/* internal function
+	rotates root with its left child
+	return	new root of the subtree
+*/
+static NODEID _rotateRight(TREE* pTree, NODEID root) {
+	NODEID pivot = LEFT(root);
+
+	LEFT(root) = RIGHT(pivot);
+	RIGHT(pivot) = root;
+
+	SIZE(pivot) = SIZE(root);
+	_update(pTree, root);
+	return pivot;
+}
+
+/* internal function
+	rotates root with its right child
+	return	new root of the subtree
+*/
+static NODEID _rotateLeft(TREE* pTree, NODEID root) {
+	NODEID pivot = RIGHT(root);
+
+	RIGHT(root) = LEFT(pivot);
+	LEFT(pivot) = root;
+
+	SIZE(pivot) = SIZE(root);
+	_update(pTree, root);
+	return pivot;
+}
+
+/* internal function
+	stores nodes of the subtree into arr in order
+	return	next index of arr
+*/
+static int _flatten(TREE* pTree, NODEID root, NODEID* arr, int index) {
+	if (root == BST_NIL) return index;
+
+	index = _flatten(pTree, LEFT(root), arr, index);
+	arr[index++] = root;
+	return _flatten(pTree, RIGHT(root), arr, index);
+}
+
+/* internal function
+	links arr[lo] ~ arr[hi - 1] into a perfectly balanced subtree
+	return	root of the subtree
+*/
+static NODEID _build(TREE* pTree, NODEID* arr, int lo, int hi) {
+	int mid;
+
+	if (lo >= hi) return BST_NIL;
+
+	mid = lo + (hi - lo) / 2;
+	LEFT(arr[mid]) = _build(pTree, arr, lo, mid);
+	RIGHT(arr[mid]) = _build(pTree, arr, mid + 1, hi);
+	_update(pTree, arr[mid]);
+	return arr[mid];
+}
+
+/* internal function
+	rebuilds the subtree of n nodes at *root into a perfectly balanced one
+	(*root becomes its new root)
+	return	1 success
+			0 overflow (the subtree is not changed)
+*/
+static int _rebuild(TREE* pTree, NODEID* root, int n) {
+	NODEID* arr;
+
+	if (n < 3) return 1;
+
+	arr = (NODEID*)malloc(sizeof(NODEID) * n);
+	if (arr == NULL) return 0;
+
+	_flatten(pTree, *root, arr, 0);
+	*root = _build(pTree, arr, 0, n);
+	free(arr);
+	return 1;
+}
+
+/* internal function
+	links nodes lo ~ hi - 1 (in key order) into a perfectly balanced subtree
+	return	root of the subtree
+*/
+static NODEID _buildRange(TREE* pTree, NODEID lo, NODEID hi) {
+	NODEID mid;
+
+	if (lo >= hi) return BST_NIL;
+
+	mid = lo + (hi - lo) / 2;
+	LEFT(mid) = _buildRange(pTree, lo, mid);
+	RIGHT(mid) = _buildRange(pTree, mid + 1, hi);
+	_update(pTree, mid);
+	return mid;
+}
+
+/* internal function
+	recomputes sizes of the whole subtree
+	return	size of root
+*/
+static int _fixSize(TREE* pTree, NODEID root) {
+	if (root == BST_NIL) return 0;
+
+	SIZE(root) = _fixSize(pTree, LEFT(root)) + COUNT(root) + _fixSize(pTree, RIGHT(root));
+	return SIZE(root);
+}
+
+/* internal function
+	links nodes 1 ~ n (in key order) into a treap by their priorities
+	(Cartesian tree: each node pops the lower-priority nodes on the right spine)
+	return	root of the treap
+			BST_NIL if overflow
+*/
+static NODEID _buildTreap(TREE* pTree, int n) {
+	NODEID* stack = (NODEID*)malloc(sizeof(NODEID) * n);
+	NODEID id, last;
+	int top = 0;
+
+	if (stack == NULL) return BST_NIL;
+
+	for (id = 1; id <= (NODEID)n; id++) {
+		last = BST_NIL;
+		while (top > 0 && _priority(pTree, stack[top - 1]) < _priority(pTree, id))
+			last = stack[--top];
+
+		LEFT(id) = last;
+		RIGHT(id) = BST_NIL;
+		if (top > 0) RIGHT(stack[top - 1]) = id;
+		stack[top++] = id;
+	}
+
+	id = stack[0];
+	free(stack);
+
+	_fixSize(pTree, id);
+	return id;
+}
+
+/* internal function
+	fills the empty pool of the tree with keys[0] ~ keys[n - 1] (ascending order)
+	nodes 1, 2, ... hold keys in order, so the pool is in key order
+	return	1 success
+			0 overflow
+*/
+static int _buildSorted(TREE* pTree, const int* keys, int n) {
+	NODEID id = BST_NIL;
+	int i;
+
+	for (i = 0; i < n; i++) {
+		// multiset: a run of equal keys is one node
+		if (pTree->multiset && id != BST_NIL && DATA(id) == keys[i]) {
+			COUNT(id)++;
+			continue;
+		}
+		id++;
+		DATA(id) = keys[i];
+		LEFT(id) = BST_NIL;
+		RIGHT(id) = BST_NIL;
+		SIZE(id) = 1;
+		COUNT(id) = 1;
+	}
+
+	pTree->pool->used = id + 1;
+	pTree->count = (int)id;
+	pTree->maxCount = (int)id;
+
+	if (pTree->mode == BST_TREAP && id > 0) {
+		pTree->root = _buildTreap(pTree, (int)id);
+		return pTree->root != BST_NIL;
+	}
+	pTree->root = _buildRange(pTree, 1, id + 1);
+	return 1;
+}
+
+/* internal function
+	sorts a[0] ~ a[n - 1] with 4 passes of 8-bit LSD radix sort (tmp holds n ints)
+*/
+static void _radixSort(int* a, int* tmp, int n) {
+	int count[256];
+	int shift, i;
+	int* src = a;
+	int* dst = tmp;
+	int* t;
+
+	for (shift = 0; shift < 32; shift += 8) {
+		memset(count, 0, sizeof(count));
+		for (i = 0; i < n; i++)
+			count[(((unsigned int)src[i] ^ 0x80000000U) >> shift) & 0xff]++;
+		for (i = 1; i < 256; i++)
+			count[i] += count[i - 1];
+		for (i = n - 1; i >= 0; i--)
+			dst[--count[(((unsigned int)src[i] ^ 0x80000000U) >> shift) & 0xff]] = src[i];
+
+		t = src;
+		src = dst;
+		dst = t;
+	}
+	// an even number of passes leaves the result in a
+}
+
+/* internal function (not mandatory)
+*/
+static void _insert(TREE* pTree, NODEID root, NODEID newPtr) {
+	NODEID cur = root;
+	NODEID p = root;
+
+	while (cur != BST_NIL) {
+		p = cur;
+		SIZE(cur)++;
+		if (DATA(cur) > DATA(newPtr))
+			cur = LEFT(cur);
+		else
+			cur = RIGHT(cur);
+	}
+
+	if (DATA(p) > DATA(newPtr)) LEFT(p) = newPtr;
+	else RIGHT(p) = newPtr;
+}
+
+/* internal function
+	inserts newPtr as a leaf, then rotates it up while its priority is higher
+	return	new root of the subtree
+*/
+static NODEID _treapInsert(TREE* pTree, NODEID root, NODEID newPtr) {
+	if (root == BST_NIL) return newPtr;
+
+	if (DATA(root) > DATA(newPtr)) {
+		LEFT(root) = _treapInsert(pTree, LEFT(root), newPtr);
+		SIZE(root)++;
+		if (_priority(pTree, LEFT(root)) > _priority(pTree, root))
+			root = _rotateRight(pTree, root);
+	}
+	else {
+		RIGHT(root) = _treapInsert(pTree, RIGHT(root), newPtr);
+		SIZE(root)++;
+		if (_priority(pTree, RIGHT(root)) > _priority(pTree, root))
+			root = _rotateLeft(pTree, root);
+	}
+	return root;
+}
+
+/* internal function
+	joins two treaps (all keys of left <= all keys of right)
+	return	root of the joined treap
+*/
+static NODEID _join(TREE* pTree, NODEID left, NODEID right) {
+	if (left == BST_NIL) return right;
+	if (right == BST_NIL) return left;
+
+	if (_priority(pTree, left) > _priority(pTree, right)) {
+		RIGHT(left) = _join(pTree, RIGHT(left), right);
+		_update(pTree, left);
+		return left;
+	}
+	LEFT(right) = _join(pTree, left, LEFT(right));
+	_update(pTree, right);
+	return right;
+}
+
+/* internal function
+	joins two subtrees (all keys of left <= all keys of right) under the largest
+	node of left, which is unlinked first (the joined tree is at most one level
+	higher than the higher of the two)
+	return	root of the joined subtree
+*/
+static NODEID _joinAtMax(TREE* pTree, NODEID left, NODEID right) {
+	NODEID max = left;
+	NODEID cur, p = BST_NIL;
+
+	if (left == BST_NIL) return right;
+	if (right == BST_NIL) return left;
+
+	while (RIGHT(max) != BST_NIL)
+		max = RIGHT(max);
+
+	// the right spine of left loses the largest node
+	for (cur = left; cur != max; cur = RIGHT(cur)) {
+		SIZE(cur) -= COUNT(max);
+		p = cur;
+	}
+	cur = max;
+	if (p == BST_NIL) left = LEFT(cur);
+	else RIGHT(p) = LEFT(cur);
+
+	LEFT(cur) = left;
+	RIGHT(cur) = right;
+	_update(pTree, cur);
+	return cur;
+}
+
+/* internal function
+	joins two subtrees (all keys of left <= all keys of right) the way the mode keeps
+	its balance: treaps by priority, other trees under the largest node of left
+	return	root of the joined subtree
+*/
+static NODEID _concat(TREE* pTree, NODEID left, NODEID right) {
+	if (pTree->mode == BST_TREAP) return _join(pTree, left, right);
+	return _joinAtMax(pTree, left, right);
+}
+
+/* internal function
+	splits the subtree into data < key (*left) and data >= key (*right) along one path
+	the number of data < key is known from a rank walk first, so every node on the
+	path gets its new size on the way down (no recursion or path stack)
+	no node moves up, so a treap stays a treap and no subtree gets higher
+*/
+static void _split(TREE* pTree, NODEID root, int key, NODEID* left, NODEID* right) {
+	NODEID* lHook = left;
+	NODEID* rHook = right;
+	NODEID cur;
+	int less = 0;
+
+	for (cur = root; cur != BST_NIL; ) {
+		if (DATA(cur) < key) {
+			less += _size(pTree, LEFT(cur)) + COUNT(cur);
+			cur = RIGHT(cur);
+		}
+		else
+			cur = LEFT(cur);
+	}
+
+	// less: number of data < key in the subtree of cur
+	for (cur = root; cur != BST_NIL; ) {
+		if (DATA(cur) < key) {
+			*lHook = cur;
+			SIZE(cur) = less;
+			less -= _size(pTree, LEFT(cur)) + COUNT(cur);
+			lHook = &RIGHT(cur);
+			cur = RIGHT(cur);
+		}
+		else {
+			*rHook = cur;
+			SIZE(cur) -= less;
+			rHook = &LEFT(cur);
+			cur = LEFT(cur);
+		}
+	}
+	*lHook = BST_NIL;
+	*rHook = BST_NIL;
+}
+
+/* internal function
+	top-down splay: brings the node with key (or the last node on its path) to
+	the root in one pass down; nodes passed go to a left tree (less than key) and
+	a right tree (greater), which become the children of the new root
+	a zig-zig step rotates first, so the path is roughly halved
+	(key is wider than int, so that INT_MAX + 1 splays the largest node)
+	sizes of the nodes linked into the left and right trees are fixed by a second
+	walk down their inner spines, from the totals kept on the way
+	return	new root of the subtree
+*/
+static NODEID _splay(TREE* pTree, NODEID root, long long key) {
+	NODEID t = root;
+	NODEID lHead = BST_NIL, lTail = BST_NIL;
+	NODEID rHead = BST_NIL, rTail = BST_NIL;
+	NODEID y;
+	int lSize = 0, rSize = 0;
+
+	if (t == BST_NIL) return BST_NIL;
+
+	for (;;) {
+		if (key < DATA(t)) {
+			y = LEFT(t);
+			if (y == BST_NIL) break;
+
+			// zig-zig: rotate right
+			if (key < DATA(y)) {
+				LEFT(t) = RIGHT(y);
+				RIGHT(y) = t;
+				_update(pTree, t);
+				t = y;
+				if (LEFT(t) == BST_NIL) break;
+			}
+
+			// t and its right subtree go to the right tree
+			if (rTail == BST_NIL) rHead = t;
+			else LEFT(rTail) = t;
+			rTail = t;
+			rSize += COUNT(t) + _size(pTree, RIGHT(t));
+			t = LEFT(t);
+		}
+		else if (key > DATA(t)) {
+			y = RIGHT(t);
+			if (y == BST_NIL) break;
+
+			// zig-zig: rotate left
+			if (key > DATA(y)) {
+				RIGHT(t) = LEFT(y);
+				LEFT(y) = t;
+				_update(pTree, t);
+				t = y;
+				if (RIGHT(t) == BST_NIL) break;
+			}
+
+			// t and its left subtree go to the left tree
+			if (lTail == BST_NIL) lHead = t;
+			else RIGHT(lTail) = t;
+			lTail = t;
+			lSize += _size(pTree, LEFT(t)) + COUNT(t);
+			t = RIGHT(t);
+		}
+		else break;
+	}
+
+	// the children of t close the inner spines of the left and right trees
+	lSize += _size(pTree, LEFT(t));
+	rSize += _size(pTree, RIGHT(t));
+	SIZE(t) = lSize + COUNT(t) + rSize;
+
+	if (lTail != BST_NIL) {
+		RIGHT(lTail) = LEFT(t);
+		LEFT(t) = lHead;
+	}
+	if (rTail != BST_NIL) {
+		LEFT(rTail) = RIGHT(t);
+		RIGHT(t) = rHead;
+	}
+
+	for (y = lHead; y != BST_NIL; y = (y == lTail) ? BST_NIL : RIGHT(y)) {
+		SIZE(y) = lSize;
+		lSize -= _size(pTree, LEFT(y)) + COUNT(y);
+	}
+	for (y = rHead; y != BST_NIL; y = (y == rTail) ? BST_NIL : LEFT(y)) {
+		SIZE(y) = rSize;
+		rSize -= COUNT(y) + _size(pTree, RIGHT(y));
+	}
+	return t;
+}
+
+/* internal function
+	splays data to the root, then puts a new node above it
+	(multiset: a splayed duplicate is counted instead)
+	return	1 success
+			0 overflow
+*/
+static int _splayInsert(TREE* pTree, int data) {
+	NODEID root = _splay(pTree, pTree->root, data);
+	NODEID newPtr;
+
+	pTree->root = root;
+	if (pTree->multiset && root != BST_NIL && DATA(root) == data) {
+		COUNT(root)++;
+		SIZE(root)++;
+		return 1;
+	}
+
+	newPtr = _makeNode(pTree, data);
+	if (newPtr == BST_NIL) return 0;
+
+	if (root != BST_NIL) {
+		if (DATA(root) > data) {
+			LEFT(newPtr) = LEFT(root);
+			RIGHT(newPtr) = root;
+			LEFT(root) = BST_NIL;
+		}
+		else {
+			RIGHT(newPtr) = RIGHT(root);
+			LEFT(newPtr) = root;
+			RIGHT(root) = BST_NIL;
+		}
+		_update(pTree, root);
+		_update(pTree, newPtr);
+	}
+
+	pTree->root = newPtr;
+	pTree->count++;
+	return 1;
+}
+
+/* internal function
+	splays dltKey to the root; the largest node of its left subtree is splayed
+	up there and takes the right subtree
+	return	1 success
+			0 not found
+*/
+static int _splayDelete(TREE* pTree, int dltKey) {
+	NODEID root = _splay(pTree, pTree->root, dltKey);
+	NODEID newRoot;
+
+	pTree->root = root;
+	if (root == BST_NIL || DATA(root) != dltKey) return 0;
+
+	// multiset: one occurrence goes away
+	if (COUNT(root) > 1) {
+		COUNT(root)--;
+		SIZE(root)--;
+		return 1;
+	}
+
+	if (LEFT(root) == BST_NIL)
+		newRoot = RIGHT(root);
+	else {
+		newRoot = _splay(pTree, LEFT(root), (long long)INT_MAX + 1);
+		RIGHT(newRoot) = RIGHT(root);
+		_update(pTree, newRoot);
+	}
+
+	_freeNode(pTree, root);
+	pTree->root = newRoot;
+	return 1;
+}
+
+/* internal function
+	success is 1 if deleted; 0 if not
+	return	new root of the subtree
+*/
+static NODEID _treapDelete(TREE* pTree, NODEID root, int dltKey, int* success) {
+	NODEID tmp;
+
+	if (root == BST_NIL) {
+		*success = 0;
+		return BST_NIL;
+	}
+
+	if (DATA(root) > dltKey)
+		LEFT(root) = _treapDelete(pTree, LEFT(root), dltKey, success);
+	else if (DATA(root) < dltKey)
+		RIGHT(root) = _treapDelete(pTree, RIGHT(root), dltKey, success);
+	else {
+		*success = 1;
+
+		// multiset: one occurrence goes away
+		if (COUNT(root) > 1) {
+			COUNT(root)--;
+			SIZE(root)--;
+			return root;
+		}
+
+		tmp = root;
+		root = _join(pTree, LEFT(root), RIGHT(root));
+		_freeNode(pTree, tmp);
+		return root;
+	}
+
+	if (*success) SIZE(root)--;
+	return root;
+}
+
+/* internal function
+	inserts newPtr as a leaf; if it lands deeper than log(count) / log(1 / alpha),
+	rebuilds the subtree of the highest unbalanced ancestor (scapegoat)
+	return	1 success
+			0 overflow (newPtr is not linked and the tree is not changed)
+*/
+static int _scapegoatInsert(TREE* pTree, NODEID newPtr) {
+	NODEID path[SG_MAX_DEPTH];
+	NODEID cur = pTree->root;
+	NODEID child;
+	double limit = 1.0;
+	int depth = 0;
+	int rebuilt = 0;
+	int childNodes, curNodes;
+	int i;
+
+	while (cur != BST_NIL) {
+		if (depth == SG_MAX_DEPTH) {
+			// reachable only if earlier rebuilds failed for overflow:
+			// takes back the path sizes and rebuilds the whole tree once
+			for (i = 0; i < depth; i++) SIZE(path[i])--;
+			if (rebuilt || !_rebuild(pTree, &pTree->root, pTree->count)) return 0;
+
+			rebuilt = 1;
+			cur = pTree->root;
+			depth = 0;
+			continue;
+		}
+		path[depth++] = cur;
+		SIZE(cur)++;
+		if (DATA(cur) > DATA(newPtr))
+			cur = LEFT(cur);
+		else
+			cur = RIGHT(cur);
+	}
+
+	if (depth == 0) pTree->root = newPtr;
+	else if (DATA(path[depth - 1]) > DATA(newPtr)) LEFT(path[depth - 1]) = newPtr;
+	else RIGHT(path[depth - 1]) = newPtr;
+
+	pTree->count++;
+	if (pTree->count > pTree->maxCount) pTree->maxCount = pTree->count;
+
+	// (1 / alpha)^depth > count means depth > log(count) / log(1 / alpha)
+	for (i = 0; i < depth; i++) limit /= pTree->alpha;
+	if (limit <= pTree->count) return 1;
+
+	// balance is by node count (sizes count occurrences in multiset mode)
+	child = newPtr;
+	childNodes = 1;
+	for (i = depth - 1; i >= 0; i--) {
+		cur = path[i];
+		curNodes = childNodes + 1 + _nodes(pTree, LEFT(cur) == child ? RIGHT(cur) : LEFT(cur));
+
+		if (childNodes > pTree->alpha * curNodes) {
+			// overflow leaves the subtree unbalanced but whole
+			if (!_rebuild(pTree, &cur, curNodes)) return 1;
+
+			if (i == 0) pTree->root = cur;
+			else if (LEFT(path[i - 1]) == path[i]) LEFT(path[i - 1]) = cur;
+			else RIGHT(path[i - 1]) = cur;
+			return 1;
+		}
+		child = cur;
+		childNodes = curNodes;
+	}
+	return 1;
+}
+
+/* internal function
+	success is 1 if deleted; 0 if not
+	return	index of root
+*/
+static NODEID _delete(TREE* pTree, NODEID root, int dltKey, int* success) {
+	NODEID cur = root;
+	NODEID p = BST_NIL;
+	NODEID tmp, tmpp;
+
+	// find dltNode
+	while (cur != BST_NIL) {
+		if (DATA(cur) == dltKey) break;
+
+		p = cur;
+		if (DATA(cur) > dltKey)
+			cur = LEFT(cur);
+		else
+			cur = RIGHT(cur);
+	}
+
+	if (cur == BST_NIL) {
+		*success = 0;
+		return root;
+	}
+
+	// the ancestors lose one occurrence (same path as the search above)
+	for (tmp = root; tmp != cur; tmp = (DATA(tmp) > dltKey) ? LEFT(tmp) : RIGHT(tmp))
+		SIZE(tmp)--;
+
+	// multiset: the node stays while it has occurrences
+	if (COUNT(cur) > 1) {
+		COUNT(cur)--;
+		SIZE(cur)--;
+		*success = 1;
+		return root;
+	}
+
+	// 0 or 1 child
+	if (LEFT(cur) == BST_NIL || RIGHT(cur) == BST_NIL) {
+		tmp = BST_NIL;
+		if (RIGHT(cur) != BST_NIL)
+			tmp = RIGHT(cur);
+		else if (LEFT(cur) != BST_NIL)
+			tmp = LEFT(cur);
+
+		if (cur == root)
+			root = tmp;
+		else if (LEFT(p) == cur)
+			LEFT(p) = tmp;
+		else if (RIGHT(p) == cur)
+			RIGHT(p) = tmp;
+		_freeNode(pTree, cur);
+	}
+	// 2 children
+	else {
+		tmpp = cur;
+		tmp = RIGHT(cur);
+		while (LEFT(tmp) != BST_NIL) {
+			tmpp = tmp;
+			tmp = LEFT(tmp);
+		}
+
+		// the successor moves up: nodes below cur on its path lose its occurrences
+		for (p = RIGHT(cur); p != tmp; p = LEFT(p))
+			SIZE(p) -= COUNT(tmp);
+		SIZE(cur)--;
+
+		DATA(cur) = DATA(tmp);
+		COUNT(cur) = COUNT(tmp);
+
+		if (tmpp == cur)
+			RIGHT(tmpp) = RIGHT(tmp);
+		else
+			LEFT(tmpp) = RIGHT(tmp);
+		_freeNode(pTree, tmp);
+	}
+
+	*success = 1;
+	return root;
+}
+
+/* internal function
+	Retrieve node containing the requested key
+	return	index of the node containing the key
+			BST_NIL not found
+*/
+static NODEID _retrieve(TREE* pTree, NODEID root, int key) {
+	NODEID cur = root;
+
+	while (cur != BST_NIL) {
+		if (DATA(cur) == key) break;
+
+		if (DATA(cur) > key)
+			cur = LEFT(cur);
+		else
+			cur = RIGHT(cur);
+	}
+
+	return cur;
+}
+
+/* internal function
+	return	number of data less than key (strict = 1) or not greater than key (strict = 0)
+*/
+static int _rank(TREE* pTree, int key, int strict) {
+	NODEID cur = pTree->root;
+	int rank = 0;
+
+	while (cur != BST_NIL) {
+		if (strict ? DATA(cur) < key : DATA(cur) <= key) {
+			rank += _size(pTree, LEFT(cur)) + COUNT(cur);
+			cur = RIGHT(cur);
+		}
+		else
+			cur = LEFT(cur);
+	}
+	return rank;
+}
+
+// the child to descend first / last in _morris
+#define NEAR(id)	(*(reverse ? &RIGHT(id) : &LEFT(id)))
+#define FAR(id)		(*(reverse ? &LEFT(id) : &RIGHT(id)))
+
+/* internal function
+	Morris traversal: visits nodes of the subtree in order (right-to-left if reverse)
+	with their depth (root is 0), without recursion or a stack
+	the last node of each near subtree is threaded to its successor while the
+	subtree is walked; all links are restored by the time it returns, so visit
+	must not change the tree
+*/
+static void _morris(TREE* pTree, NODEID root, int reverse,
+	void (*visit)(TREE* pTree, NODEID id, int level, void* arg), void* arg) {
+	NODEID cur = root;
+	NODEID pred;
+	int level = 0;
+	int d;
+
+	while (cur != BST_NIL) {
+		if (NEAR(cur) != BST_NIL) {
+			// predecessor: d steps down from cur
+			pred = NEAR(cur);
+			d = 1;
+			while (FAR(pred) != BST_NIL && FAR(pred) != cur) {
+				pred = FAR(pred);
+				d++;
+			}
+
+			// first arrival: threads the predecessor and goes down
+			if (FAR(pred) == BST_NIL) {
+				FAR(pred) = cur;
+				cur = NEAR(cur);
+				level++;
+				continue;
+			}
+
+			// back through the thread (which counted as a step down)
+			FAR(pred) = BST_NIL;
+			level -= d + 1;
+		}
+
+		(*visit)(pTree, cur, level, arg);
+		cur = FAR(cur);
+		level++;
+	}
+}
+
+#undef NEAR
+#undef FAR
+
+/* internal visit function: prints each occurrence of data
+*/
+static void _traverse(TREE* pTree, NODEID id, int level, void* arg) {
+	for (int i = 0; i < COUNT(id); i++)
+		printf("%d ", DATA(id));
+}
+
+/* internal visit function: prints data indented by its level
+*/
+static void _inorder_print(TREE* pTree, NODEID id, int level, void* arg) {
+	for (int i = 0; i < level; i++) printf("\t");
+	if (COUNT(id) > 1) printf("%d (x%d)\n", DATA(id), COUNT(id));
+	else printf("%d\n", DATA(id));
+}
+
+/* internal visit function: keeps the largest level + 1 in *arg
+*/
+static void _height(TREE* pTree, NODEID id, int level, void* arg) {
+	int* height = (int*)arg;
+
+	if (level >= *height) *height = level + 1;
+}
+
+/* internal visit function: counts nodes in *arg
+*/
+static void _countNode(TREE* pTree, NODEID id, int level, void* arg) {
+	(*(int*)arg)++;
+}
+
+/* internal function
+	return	number of nodes in the subtree (O(1) unless multiset, O(nodes) then)
+*/
+static int _countNodes(TREE* pTree, NODEID root) {
+	int n = 0;
+
+	if (!pTree->multiset) return _size(pTree, root);
+
+	_morris(pTree, root, 0, _countNode, &n);
+	return n;
+}
+
+/* internal function
+	pushes a node on the iterator path; the path moves from local to the heap
+	(and grows by doubling) once it is deeper than BST_ITER_DEPTH
+	return	1 success
+			0 overflow
+*/
+static int _iterPush(BST_ITER* pIter, NODEID id) {
+	NODEID* path;
+
+	if (pIter->top == pIter->capacity) {
+		if (pIter->heap == NULL) {
+			path = (NODEID*)malloc(sizeof(NODEID) * pIter->capacity * 2);
+			if (path != NULL) memcpy(path, pIter->local, sizeof(NODEID) * pIter->top);
+		}
+		else
+			path = (NODEID*)realloc(pIter->heap, sizeof(NODEID) * pIter->capacity * 2);
+		if (path == NULL) return 0;
+
+		pIter->heap = path;
+		pIter->capacity *= 2;
+	}
+
+	path = (pIter->heap != NULL) ? pIter->heap : pIter->local;
+	path[pIter->top++] = id;
+	return 1;
+}
+
+/* internal function
+	pushes the left spine of the subtree, skipping nodes with data < lo
+	(the path then holds every node >= lo whose left part is pending)
+	return	1 success
+			0 overflow
+*/
+static int _iterDescend(BST_ITER* pIter, NODEID cur, int lo) {
+	TREE* pTree = pIter->tree;
+
+	while (cur != BST_NIL) {
+		if (DATA(cur) < lo)
+			cur = RIGHT(cur);
+		else {
+			if (!_iterPush(pIter, cur)) return 0;
+			cur = LEFT(cur);
+		}
+	}
+	return 1;
+}
+
+/* internal function
+	starts an iterator at the first data >= lo
+	return	1 success
+			0 overflow
+*/
+static int _iterSeek(TREE* pTree, BST_ITER* pIter, int lo) {
+	pIter->tree = pTree;
+	pIter->heap = NULL;
+	pIter->top = 0;
+	pIter->capacity = BST_ITER_DEPTH;
+	pIter->cur = BST_NIL;
+	pIter->left = 0;
+
+	if (_iterDescend(pIter, pTree->root, lo)) return 1;
+
+	BST_IterEnd(pIter);
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Allocates dynamic memory for a tree head node and returns its address to caller
+	return	head node pointer
+			NULL if overflow
+*/
+TREE* BST_Create(void) {
+	return BST_CreateMode(BST_PLAIN);
+}
+
+/* Allocates a tree head node with a tree mode (BST_PLAIN, BST_TREAP, BST_SCAPEGOAT,
+	BST_SPLAY), optionally with BST_MULTISET
+	return	head node pointer
+			NULL if overflow or unknown mode
+*/
+TREE* BST_CreateMode(int mode) {
+	TREE* pTree;
+
+	int multiset = (mode & BST_MULTISET) != 0;
+
+	mode &= ~BST_MULTISET;
+	if (mode < BST_PLAIN || mode > BST_SPLAY) return NULL;
+
+	pTree = (TREE*)malloc(sizeof(TREE));
+	if (pTree == NULL) return NULL;
+
+	pTree->pool = _makePool(BST_POOL_INIT);
+	if (pTree->pool == NULL) {
+		free(pTree);
+		return NULL;
+	}
+
+	pTree->root = BST_NIL;
+	pTree->count = 0;
+	pTree->mode = mode;
+	pTree->multiset = multiset;
+	pTree->seed = (unsigned int)rand() * 2654435761U;
+	pTree->maxCount = 0;
+	pTree->alpha = BST_ALPHA;
+	return pTree;
+}
+
+/* Sets the balance factor of a scapegoat tree (clamped to BST_ALPHA_MIN ~ BST_ALPHA_MAX)
+*/
+void BST_SetAlpha(TREE* pTree, double alpha) {
+	if (alpha < BST_ALPHA_MIN) alpha = BST_ALPHA_MIN;
+	if (alpha > BST_ALPHA_MAX) alpha = BST_ALPHA_MAX;
+
+	pTree->alpha = alpha;
+}
+
+/* Deletes all data in tree and recycles memory (O(1): the pool is released at once)
+*/
+void BST_Destroy(TREE* pTree) {
+	// a shared pool takes the nodes back for the other trees
+	if (pTree->pool->refs > 1) _freeSubtree(pTree, pTree->root, pTree->count);
+	_releasePool(pTree->pool);
+	free(pTree);
+}
+
+/* Replaces all data in tree with keys[0] ~ keys[n - 1] (ascending order) in O(n)
+	nodes are allocated in one block in key order; the tree is perfectly balanced
+	(a treap gets the heap order of its priorities instead)
+	return	1 success
+			0 overflow or keys not sorted (tree is not changed)
+*/
+int BST_BuildFromSorted(TREE* pTree, const int* keys, int n) {
+	TREE fresh = *pTree;
+	NODEID capacity = (n + 1 > BST_POOL_INIT) ? (NODEID)n + 1 : BST_POOL_INIT;
+	int i;
+
+	if (n < 0) return 0;
+	for (i = 1; i < n; i++)
+		if (keys[i - 1] > keys[i]) return 0;
+
+	// the new tree is built whole in its own pool before the old nodes go
+	fresh.pool = _makePool(capacity);
+	if (fresh.pool == NULL) return 0;
+
+	if (!_buildSorted(&fresh, keys, n)) {
+		_releasePool(fresh.pool);
+		return 0;
+	}
+
+	// a shared pool takes the old nodes back for the other trees
+	if (pTree->pool->refs > 1) _freeSubtree(pTree, pTree->root, pTree->count);
+	_releasePool(pTree->pool);
+	*pTree = fresh;
+	return 1;
+}
+
+/* Replaces all data in tree with keys[0] ~ keys[n - 1] (any order)
+	keys are radix sorted into a copy (O(n)), then built by BST_BuildFromSorted
+	return	1 success
+			0 overflow
+*/
+int BST_BuildFromArray(TREE* pTree, const int* keys, int n) {
+	int* sorted;
+	int* tmp;
+	int ret;
+	int i;
+
+	if (n < 0) return 0;
+
+	// already sorted: no copy needed
+	for (i = 1; i < n; i++)
+		if (keys[i - 1] > keys[i]) break;
+	if (i >= n) return BST_BuildFromSorted(pTree, keys, n);
+
+	sorted = (int*)malloc(sizeof(int) * n);
+	tmp = (int*)malloc(sizeof(int) * n);
+	if (sorted == NULL || tmp == NULL) {
+		free(sorted);
+		free(tmp);
+		return 0;
+	}
+
+	memcpy(sorted, keys, sizeof(int) * n);
+	_radixSort(sorted, tmp, n);
+	free(tmp);
+
+	ret = BST_BuildFromSorted(pTree, sorted, n);
+	free(sorted);
+	return ret;
+}
+
+/* Inserts new data into the tree
+	return	1 success
+			0 overflow
+*/
+int BST_Insert(TREE* pTree, int data) {
+	NODEID pNode;
+
+	if (pTree->mode == BST_SPLAY) return _splayInsert(pTree, data);
+
+	// multiset: counts a duplicate on its node (same path as _retrieve)
+	if (pTree->multiset && (pNode = _retrieve(pTree, pTree->root, data)) != BST_NIL) {
+		NODEID cur;
+
+		for (cur = pTree->root; cur != pNode; cur = (DATA(cur) > data) ? LEFT(cur) : RIGHT(cur))
+			SIZE(cur)++;
+		SIZE(pNode)++;
+		COUNT(pNode)++;
+		return 1;
+	}
+
+	pNode = _makeNode(pTree, data);
+	if (pNode == BST_NIL) return 0;
+
+	switch (pTree->mode) {
+		case BST_TREAP:
+			pTree->root = _treapInsert(pTree, pTree->root, pNode);
+			break;
+
+		case BST_SCAPEGOAT:
+			if (!_scapegoatInsert(pTree, pNode)) {
+				_freeNode(pTree, pNode);
+				pTree->count++; // pNode was never counted
+				return 0;
+			}
+			return 1;
+
+		default:
+			if (pTree->root == BST_NIL) pTree->root = pNode;
+			else _insert(pTree, pTree->root, pNode);
+			break;
+	}
+
+	pTree->count++;
+	return 1;
+}
+
+/* Deletes a node with dltKey from the tree
+	return	1 success
+			0 not found
+*/
+int BST_Delete(TREE* pTree, int dltKey) {
+	int success;
+
+	if (pTree->mode == BST_SPLAY) return _splayDelete(pTree, dltKey);
+
+	if (pTree->mode == BST_TREAP)
+		pTree->root = _treapDelete(pTree, pTree->root, dltKey, &success);
+	else
+		pTree->root = _delete(pTree, pTree->root, dltKey, &success);
+
+	if (!success) return 0;
+
+	// scapegoat: rebuilds the whole tree after enough deletions
+	if (pTree->mode == BST_SCAPEGOAT && pTree->count < pTree->alpha * pTree->maxCount) {
+		if (_rebuild(pTree, &pTree->root, pTree->count)) pTree->maxCount = pTree->count;
+	}
+	return 1;
+}
+
+/* Retrieve tree for the node containing the requested key
+	(BST_SPLAY: the last node on the search path moves to the root, so a
+	retrieve changes the tree)
+	return	address of data of the node containing the key
+			(valid until the next insertion, which may move the pool)
+			NULL not found
+*/
+int* BST_Retrieve(TREE* pTree, int key) {
+	NODEID find;
+
+	if (pTree->mode == BST_SPLAY) {
+		pTree->root = _splay(pTree, pTree->root, key);
+		find = (pTree->root != BST_NIL && DATA(pTree->root) == key) ? pTree->root : BST_NIL;
+	}
+	else find = _retrieve(pTree, pTree->root, key);
+
+	if (find == BST_NIL) return NULL;
+	else return &DATA(find);
+}
+
+/* prints tree using inorder traversal (O(1) extra space)
+*/
+void BST_Traverse(TREE* pTree) {
+	_morris(pTree, pTree->root, 0, _traverse, NULL);
+}
+
+/* Print tree using inorder right-to-left traversal (O(1) extra space)
+*/
+void printTree(TREE* pTree) {
+	_morris(pTree, pTree->root, 1, _inorder_print, NULL);
+}
+
+/*
+	return 1 if the tree is empty; 0 if not
+*/
+int BST_Empty(TREE* pTree) {
+	if (pTree->root == BST_NIL)
+		return 1;
+	else
+		return 0;
+}
+
+/* return number of data in the tree (counting every occurrence)
+*/
+int BST_Count(TREE* pTree) {
+	return _size(pTree, pTree->root);
+}
+
+/* return number of nodes in the tree (distinct data in multiset mode)
+*/
+int BST_Nodes(TREE* pTree) {
+	return pTree->count;
+}
+
+/* return height of the tree (0 for an empty tree)
+*/
+int BST_Height(TREE* pTree) {
+	int height = 0;
+
+	_morris(pTree, pTree->root, 0, _height, &height);
+	return height;
+}
+
+/* return depth of the node containing key (0 for the root; the tree is not changed)
+			-1 not found
+*/
+int BST_Depth(TREE* pTree, int key) {
+	NODEID cur = pTree->root;
+	int depth = 0;
+
+	while (cur != BST_NIL) {
+		if (DATA(cur) == key) return depth;
+
+		cur = (DATA(cur) > key) ? LEFT(cur) : RIGHT(cur);
+		depth++;
+	}
+	return -1;
+}
+
+/* return bytes allocated for the tree (head and node pool; a shared pool is counted in full)
+*/
+size_t BST_Bytes(TREE* pTree) {
+	return sizeof(TREE) + sizeof(NODEPOOL) + sizeof(NODE) * (size_t)pTree->pool->capacity;
+}
+
+/* return number of data less than or equal to key
+	(1-based rank of key if it is in tree)
+*/
+int BST_Rank(TREE* pTree, int key) {
+	return _rank(pTree, key, 0);
+}
+
+/* passes back the k-th (1-based) smallest data
+	return	1 success
+			0 k is out of range
+*/
+int BST_Select(TREE* pTree, int k, int* dataOut) {
+	NODEID cur = pTree->root;
+	int leftSize;
+
+	if (k < 1 || k > _size(pTree, cur)) return 0;
+
+	while (cur != BST_NIL) {
+		leftSize = _size(pTree, LEFT(cur));
+
+		if (k <= leftSize)
+			cur = LEFT(cur);
+		else if (k <= leftSize + COUNT(cur)) {
+			*dataOut = DATA(cur);
+			return 1;
+		}
+		else {
+			k -= leftSize + COUNT(cur);
+			cur = RIGHT(cur);
+		}
+	}
+	return 0;
+}
+
+/* return number of data in [lo, hi]
+*/
+int BST_CountRange(TREE* pTree, int lo, int hi) {
+	if (lo > hi) return 0;
+
+	return _rank(pTree, hi, 0) - _rank(pTree, lo, 1);
+}
+
+/* visits data in [lo, hi] in order (O(height + number of visited data))
+	return	1 success
+			0 overflow
+*/
+int BST_RangeVisit(TREE* pTree, int lo, int hi, void (*callback)(int data)) {
+	BST_ITER iter;
+	int data;
+
+	if (lo > hi) return 1;
+	if (!_iterSeek(pTree, &iter, lo)) return 0;
+
+	while (BST_IterNext(&iter, &data)) {
+		if (data > hi) break;
+		(*callback)(data);
+	}
+	BST_IterEnd(&iter);
+	return 1;
+}
+
+/* Splits tree into data < key (left) and data >= key (right); tree is used up
+	(left reuses its head) and both share its node pool
+	(multiset: the nodes of the smaller side are counted, in O(its nodes))
+	return	1 success
+			0 overflow (tree is not changed)
+*/
+int BST_Split(TREE* pTree, int key, TREE** left, TREE** right) {
+	TREE* pRight = (TREE*)malloc(sizeof(TREE));
+	NODEID l, r;
+	int nodes;
+
+	if (pRight == NULL) return 0;
+
+	*pRight = *pTree;
+	pTree->pool->refs++;
+
+	_split(pTree, pTree->root, key, &l, &r);
+	pTree->root = l;
+	pRight->root = r;
+
+	if (_size(pTree, l) <= _size(pTree, r)) {
+		nodes = _countNodes(pTree, l);
+		pRight->count = pTree->count - nodes;
+		pTree->count = nodes;
+	}
+	else {
+		nodes = _countNodes(pTree, r);
+		pTree->count -= nodes;
+		pRight->count = nodes;
+	}
+	pTree->maxCount = pTree->count;
+	pRight->maxCount = pRight->count;
+
+	*left = pTree;
+	*right = pRight;
+	return 1;
+}
+
+/* Joins right into left when all data of left <= all data of right; right is used up
+	O(height) if they share a pool (as split trees do); otherwise the data of
+	right are inserted into left (multiset: a key on both sides stays one node)
+	return	joined tree (left)
+			NULL if the data overlap or overflow (neither is changed by overlap)
+*/
+TREE* BST_Join(TREE* left, TREE* right) {
+	TREE* pTree = left;
+	NODEID max = left->root;
+	NODEID min = right->root;
+	BST_ITER iter;
+	int data;
+
+	// largest data of left against smallest data of right
+	if (max != BST_NIL && min != BST_NIL) {
+		while (RIGHT(max) != BST_NIL) max = RIGHT(max);
+		while (right->pool->nodes[min].left != BST_NIL) min = right->pool->nodes[min].left;
+
+		if (right->pool->nodes[min].data < DATA(max)) return NULL;
+	}
+
+	if (left->pool == right->pool) {
+		// multiset: a key on both sides stays one node (the smallest of right
+		// gives its occurrences to the largest of left and leaves the pool)
+		if (pTree->multiset && max != BST_NIL && min != BST_NIL && DATA(min) == DATA(max)) {
+			NODEID cur, p = BST_NIL;
+
+			for (cur = right->root; cur != min; cur = LEFT(cur)) {
+				SIZE(cur) -= COUNT(min);
+				p = cur;
+			}
+			if (p == BST_NIL) right->root = RIGHT(min);
+			else LEFT(p) = RIGHT(min);
+
+			for (cur = left->root; cur != max; cur = RIGHT(cur))
+				SIZE(cur) += COUNT(min);
+			SIZE(max) += COUNT(min);
+			COUNT(max) += COUNT(min);
+			_freeNode(right, min);
+		}
+		pTree->root = _concat(pTree, left->root, right->root);
+		pTree->count += right->count;
+		if (pTree->count > pTree->maxCount) pTree->maxCount = pTree->count;
+
+		_releasePool(right->pool);
+		free(right);
+		return left;
+	}
+
+	if (!BST_IterBegin(right, &iter)) return NULL;
+	while (BST_IterNext(&iter, &data))
+		if (!BST_Insert(left, data)) {
+			BST_IterEnd(&iter);
+			return NULL;
+		}
+
+	BST_Destroy(right);
+	return left;
+}
+
+/* Deletes all data in [lo, hi]: two splits and a join (O(height)); the removed
+	subtree goes to the pool at once and its nodes are reused one by one later
+	(multiset: plus a walk of the removed nodes to count them)
+	return	number of data deleted
+*/
+int BST_DeleteRange(TREE* pTree, int lo, int hi) {
+	NODEID less, mid, greater = BST_NIL;
+	int deleted;
+
+	if (lo > hi) return 0;
+
+	_split(pTree, pTree->root, lo, &less, &mid);
+	if (hi < INT_MAX) _split(pTree, mid, hi + 1, &mid, &greater);
+
+	deleted = _size(pTree, mid);
+	_freeSubtree(pTree, mid, _countNodes(pTree, mid));
+	pTree->root = _concat(pTree, less, greater);
+
+	// scapegoat: the same rebuild rule as BST_Delete
+	if (pTree->mode == BST_SCAPEGOAT && pTree->count < pTree->alpha * pTree->maxCount) {
+		if (_rebuild(pTree, &pTree->root, pTree->count)) pTree->maxCount = pTree->count;
+	}
+	return deleted;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* starts an in-order iterator at the smallest data
+	return	1 success
+			0 overflow
+*/
+int BST_IterBegin(TREE* pTree, BST_ITER* pIter) {
+	return _iterSeek(pTree, pIter, INT_MIN);
+}
+
+/* passes back the next data in order (each occurrence in multiset mode)
+	return	1 success
+			0 end of tree (the iterator is released) or overflow
+*/
+int BST_IterNext(BST_ITER* pIter, int* dataOut) {
+	TREE* pTree = pIter->tree;
+	NODEID* path;
+
+	if (pIter->left == 0) {
+		if (pIter->top == 0) {
+			BST_IterEnd(pIter);
+			return 0;
+		}
+
+		path = (pIter->heap != NULL) ? pIter->heap : pIter->local;
+		pIter->cur = path[--pIter->top];
+		pIter->left = COUNT(pIter->cur);
+
+		if (!_iterDescend(pIter, RIGHT(pIter->cur), INT_MIN)) {
+			BST_IterEnd(pIter);
+			return 0;
+		}
+	}
+
+	pIter->left--;
+	*dataOut = DATA(pIter->cur);
+	return 1;
+}
+
+/* releases an iterator before its end (no-op after BST_IterNext returned 0)
+*/
+void BST_IterEnd(BST_ITER* pIter) {
+	free(pIter->heap);
+	pIter->heap = NULL;
+	pIter->top = 0;
+	pIter->left = 0;
+}
@@ -0,0 +1,250 @@
+#include <stddef.h> // size_t
+
+////////////////////////////////////////////////////////////////////////////////
+// tree modes (BST_CreateMode)
+#define BST_PLAIN		0	// no rebalancing (insertion order decides the shape)
+#define BST_TREAP		1	// randomized treap (expected O(log n) height)
+#define BST_SCAPEGOAT	2	// scapegoat tree (height <= log(n) / log(1 / alpha) + 1)
+#define BST_SPLAY		3	// top-down splay tree (accessed data moves to the root; amortized O(log n))
+
+// mode flag: a node counts the occurrences of its data instead of adding
+// a node per duplicate (e.g. BST_TREAP | BST_MULTISET)
+#define BST_MULTISET	0x10
+
+// scapegoat balance factor (BST_SetAlpha): 0.5 < alpha < 1
+// smaller alpha keeps the tree lower but rebuilds more often
+#define BST_ALPHA		0.7
+#define BST_ALPHA_MIN	0.55
+#define BST_ALPHA_MAX	0.95
+
+// first capacity of the node pool
+#define BST_POOL_INIT	64
+
+////////////////////////////////////////////////////////////////////////////////
+// TREE type definition
+// nodes live in one growable array (node pool) and link each other by 32-bit
+// index; index 0 (BST_NIL) is never used, so it stands for an empty subtree
+// trees made by BST_Split share the pool of the tree they came from
+typedef unsigned int NODEID;
+
+#define BST_NIL		0
+
+typedef struct
+{
+	int			data;
+	NODEID		left;
+	NODEID		right;
+	int			size;	// number of data in the subtree rooted here
+	int			count;	// occurrences of data (1 unless BST_MULTISET)
+} NODE;
+
+typedef struct
+{
+	NODE*	nodes;		// nodes[BST_NIL] is unused
+	NODEID	capacity;	// allocated nodes in pool
+	NODEID	used;		// nodes[1] ~ nodes[used - 1] have been handed out
+	NODEID	freeList;	// nodes released by delete, linked through left
+	NODEID	lazyList;	// roots of whole subtrees released by BST_DeleteRange, linked
+						// through data; a node taken from here puts its children back
+	int		refs;		// trees using the pool
+} NODEPOOL;
+
+typedef struct
+{
+	NODEPOOL* pool;
+	NODEID	root;
+	int		count;		// number of nodes
+	int		mode;		// BST_PLAIN, BST_TREAP, BST_SCAPEGOAT or BST_SPLAY
+	int		multiset;	// 1 if created with BST_MULTISET
+	unsigned int seed;	// treap priority seed
+	int		maxCount;	// scapegoat: largest count since the last full rebuild
+	double	alpha;		// scapegoat balance factor
+} TREE;
+
+// in-order iterator (BST_IterBegin)
+// the path of pending nodes stays in local until it is deeper than BST_ITER_DEPTH,
+// then moves to the heap; the tree must not change while it is in use
+#define BST_ITER_DEPTH	64
+
+typedef struct
+{
+	TREE*	tree;
+	NODEID*	heap;		// path on the heap (NULL while local is enough)
+	int		top;		// number of nodes on the path
+	int		capacity;
+	NODEID	cur;		// node being passed back
+	int		left;		// occurrences of cur not passed back yet
+	NODEID	local[BST_ITER_DEPTH];
+} BST_ITER;
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Allocates dynamic memory for a tree head node and returns its address to caller
+	return	head node pointer
+			NULL if overflow
+*/
+TREE* BST_Create(void);
+
+/* Allocates a tree head node with a tree mode (BST_PLAIN, BST_TREAP, BST_SCAPEGOAT,
+	BST_SPLAY), optionally with BST_MULTISET
+	return	head node pointer
+			NULL if overflow or unknown mode
+*/
+TREE* BST_CreateMode(int mode);
+
+/* Sets the balance factor of a scapegoat tree (clamped to BST_ALPHA_MIN ~ BST_ALPHA_MAX)
+*/
+void BST_SetAlpha(TREE* pTree, double alpha);
+
+/* Deletes all data in tree and recycles memory (O(1): the pool is released at once)
+*/
+void BST_Destroy(TREE* pTree);
+
+/* Replaces all data in tree with keys[0] ~ keys[n - 1] (ascending order) in O(n)
+	nodes are allocated in one block in key order; the tree is perfectly balanced
+	(a treap gets the heap order of its priorities instead)
+	multiset: equal keys share one node
+	return	1 success
+			0 overflow or keys not sorted (tree is not changed)
+*/
+int BST_BuildFromSorted(TREE* pTree, const int* keys, int n);
+
+/* Replaces all data in tree with keys[0] ~ keys[n - 1] (any order)
+	keys are radix sorted into a copy (O(n)), then built by BST_BuildFromSorted
+	return	1 success
+			0 overflow
+*/
+int BST_BuildFromArray(TREE* pTree, const int* keys, int n);
+
+/* Inserts new data into the tree
+	(multiset: increments the count of data if it is in the tree)
+	return	1 success
+			0 overflow
+*/
+int BST_Insert(TREE* pTree, int data);
+
+/* Deletes a node with dltKey from the tree
+	(multiset: decrements the count; the node goes away at zero)
+	return	1 success
+			0 not found
+*/
+int BST_Delete(TREE* pTree, int dltKey);
+
+/* Retrieve tree for the node containing the requested key
+	(BST_SPLAY: the last node on the search path moves to the root, so a
+	retrieve changes the tree)
+	return	address of data of the node containing the key
+			(valid until the next insertion, which may move the pool)
+			NULL not found
+*/
+int* BST_Retrieve(TREE* pTree, int key);
+
+/* prints tree using inorder traversal (each occurrence of data)
+	Morris traversal: no recursion and O(1) extra space, even for a degenerate tree
+*/
+void BST_Traverse(TREE* pTree);
+
+/* Print tree using inorder right-to-left traversal (Morris traversal, as BST_Traverse)
+*/
+void printTree(TREE* pTree);
+
+/*
+	return 1 if the tree is empty; 0 if not
+*/
+int BST_Empty(TREE* pTree);
+
+/* return number of data in the tree (counting every occurrence)
+*/
+int BST_Count(TREE* pTree);
+
+/* return number of nodes in the tree (distinct data in multiset mode)
+*/
+int BST_Nodes(TREE* pTree);
+
+/* return height of the tree (0 for an empty tree)
+*/
+int BST_Height(TREE* pTree);
+
+/* return depth of the node containing key (0 for the root; the tree is not changed)
+			-1 not found
+*/
+int BST_Depth(TREE* pTree, int key);
+
+/* return bytes allocated for the tree (head and node pool; a shared pool is counted in full)
+*/
+size_t BST_Bytes(TREE* pTree);
+
+////////////////////////////////////////////////////////////////////////////////
+// order statistics (O(height) by subtree sizes)
+
+/* return number of data less than or equal to key
+	(1-based rank of key if it is in tree)
+*/
+int BST_Rank(TREE* pTree, int key);
+
+/* passes back the k-th (1-based) smallest data
+	return	1 success
+			0 k is out of range
+*/
+int BST_Select(TREE* pTree, int k, int* dataOut);
+
+/* return number of data in [lo, hi]
+*/
+int BST_CountRange(TREE* pTree, int lo, int hi);
+
+/* visits data in [lo, hi] in order (O(height + number of visited data))
+	callback is called for each occurrence
+	return	1 success
+			0 overflow
+*/
+int BST_RangeVisit(TREE* pTree, int lo, int hi, void (*callback)(int data));
+
+////////////////////////////////////////////////////////////////////////////////
+// split and join (O(height) in a treap; plain and scapegoat trees cut the same
+// paths and join under the largest node of left, one level higher)
+
+/* Splits tree into data < key (left) and data >= key (right); tree is used up
+	(left reuses its head) and both share its node pool
+	(multiset: the nodes of the smaller side are counted, in O(its nodes))
+	return	1 success
+			0 overflow (tree is not changed)
+*/
+int BST_Split(TREE* pTree, int key, TREE** left, TREE** right);
+
+/* Joins right into left when all data of left <= all data of right; right is used up
+	O(height) if they share a pool (as split trees do); otherwise the data of
+	right are inserted into left (multiset: a key on both sides stays one node)
+	return	joined tree (left)
+			NULL if the data overlap or overflow (neither is changed by overlap)
+*/
+TREE* BST_Join(TREE* left, TREE* right);
+
+/* Deletes all data in [lo, hi]: two splits and a join (O(height)); the removed
+	subtree goes to the pool at once and its nodes are reused one by one later
+	(multiset: plus a walk of the removed nodes to count them)
+	return	number of data deleted
+*/
+int BST_DeleteRange(TREE* pTree, int lo, int hi);
+
+////////////////////////////////////////////////////////////////////////////////
+// in-order iteration (no recursion; O(height) path, on the heap only for deep trees)
+//	BST_ITER iter;
+//	if (BST_IterBegin(tree, &iter))
+//		while (BST_IterNext(&iter, &data)) ...
+
+/* starts an in-order iterator at the smallest data
+	return	1 success
+			0 overflow
+*/
+int BST_IterBegin(TREE* pTree, BST_ITER* pIter);
+
+/* passes back the next data in order (each occurrence in multiset mode)
+	return	1 success
+			0 end of tree (the iterator is released) or overflow
+*/
+int BST_IterNext(BST_ITER* pIter, int* dataOut);
+
+/* releases an iterator before its end (no-op after BST_IterNext returned 0)
+*/
+void BST_IterEnd(BST_ITER* pIter);
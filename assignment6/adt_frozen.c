@@ -0,0 +1,154 @@
+#include <stdlib.h> // malloc, aligned_alloc, free
+
+#include "adt_bst.h"
+#include "adt_frozen.h"
+
+#define CACHE_LINE	64
+
+// keys per cache line; a search prefetches the line of the node 4 levels down
+// (keys[16k] ~ keys[16k + 15] are the 16 great-great-grandchildren of keys[k])
+#define LINE_KEYS	(CACHE_LINE / sizeof(int))
+
+/* internal function
+	return	first Eytzinger index in order (the leftmost node)
+*/
+static int _first(int n) {
+	int k = 1;
+
+	while (2 * k <= n) k *= 2;
+	return k;
+}
+
+/* internal function
+	return	Eytzinger index after k in order
+			0 if k is the last
+*/
+static int _next(int k, int n) {
+	// the leftmost node of the right subtree
+	if (2 * k + 1 <= n) {
+		k = 2 * k + 1;
+		while (2 * k <= n) k *= 2;
+		return k;
+	}
+
+	// up past the ancestors whose right subtree it was
+	while (k & 1) k >>= 1;
+	return k >> 1;
+}
+
+/* internal function
+	branchless descent: every level goes to 2k + (keys[k] < key) without a
+	conditional jump, while the line 4 levels ahead is being loaded; the right
+	turns taken after the last left turn are trailing 1 bits of k, so shifting
+	them out lands on the last node where it went left (the lower bound)
+	return	Eytzinger index of the smallest key not less than key
+			0 if none
+*/
+static int _lowerBound(FROZEN* pFrozen, int key) {
+	const int* keys = pFrozen->keys;
+	unsigned int k = 1;
+	unsigned int n = (unsigned int)pFrozen->n;
+
+	while (k <= n) {
+		__builtin_prefetch(keys + LINE_KEYS * k);
+		k = 2 * k + (keys[k] < key);
+	}
+	k >>= __builtin_ffs((int)~k);
+	return (int)k;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Copies the distinct data of tree into a new frozen set (O(n), without recursion);
+	the tree is not changed and can be destroyed afterwards
+	return	frozen set
+			NULL if overflow
+*/
+FROZEN* BST_Freeze(TREE* pTree) {
+	FROZEN* pFrozen;
+	BST_ITER iter;
+	size_t bytes;
+	int data, prev = 0;
+	int n = 0;
+	int seen = 0;
+	int k;
+
+	// first pass: number of distinct data decides the shape
+	if (!BST_IterBegin(pTree, &iter)) return NULL;
+	while (BST_IterNext(&iter, &data)) {
+		if (n == 0 || data != prev) n++;
+		prev = data;
+	}
+
+	pFrozen = (FROZEN*)malloc(sizeof(FROZEN));
+	if (pFrozen == NULL) return NULL;
+
+	// whole lines, so that the array starts on a line of its own
+	bytes = sizeof(int) * ((size_t)n + 1);
+	bytes = (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+	pFrozen->keys = (int*)aligned_alloc(CACHE_LINE, bytes);
+	if (pFrozen->keys == NULL) {
+		free(pFrozen);
+		return NULL;
+	}
+	pFrozen->n = n;
+
+	// second pass: in-order data go to in-order Eytzinger indices
+	if (!BST_IterBegin(pTree, &iter)) {
+		Frozen_Destroy(pFrozen);
+		return NULL;
+	}
+	k = (n > 0) ? _first(n) : 0;
+	while (BST_IterNext(&iter, &data)) {
+		if (seen++ > 0 && data == prev) continue;
+
+		pFrozen->keys[k] = data;
+		prev = data;
+		k = _next(k, n);
+	}
+	return pFrozen;
+}
+
+/* Deletes a frozen set and recycles memory
+*/
+void Frozen_Destroy(FROZEN* pFrozen) {
+	free(pFrozen->keys);
+	free(pFrozen);
+}
+
+/* Retrieve frozen set for the requested key (branchless search with prefetch)
+	return	address of the key in the set
+			NULL not found
+*/
+int* Frozen_Retrieve(FROZEN* pFrozen, int key) {
+	int k = _lowerBound(pFrozen, key);
+
+	if (k != 0 && pFrozen->keys[k] == key) return &pFrozen->keys[k];
+	else return NULL;
+}
+
+/* passes back the smallest data not less than key (branchless search with prefetch)
+	return	1 success
+			0 every data is less than key
+*/
+int Frozen_LowerBound(FROZEN* pFrozen, int key, int* dataOut) {
+	int k = _lowerBound(pFrozen, key);
+
+	if (k == 0) return 0;
+
+	*dataOut = pFrozen->keys[k];
+	return 1;
+}
+
+/* return number of distinct data in the set
+*/
+int Frozen_Count(FROZEN* pFrozen) {
+	return pFrozen->n;
+}
+
+/* return bytes allocated for the set (head and array)
+*/
+size_t Frozen_Bytes(FROZEN* pFrozen) {
+	size_t bytes = sizeof(int) * ((size_t)pFrozen->n + 1);
+
+	return sizeof(FROZEN) + (bytes + CACHE_LINE - 1) / CACHE_LINE * CACHE_LINE;
+}
@@ -0,0 +1,48 @@
+#include <stddef.h> // size_t
+
+////////////////////////////////////////////////////////////////////////////////
+// Frozen (read-only) integer set in Eytzinger layout
+// a snapshot of a TREE (include adt_bst.h first) stored as an implicit binary
+// tree in one array: the children of keys[k] are keys[2k] and keys[2k + 1], so
+// a search needs no pointers, walks the array front to back, and the top levels
+// of every search share the same few cache lines
+
+typedef struct
+{
+	int*	keys;	// keys[1] ~ keys[n] in Eytzinger order (keys[0] is unused)
+	int		n;		// number of distinct keys
+} FROZEN;
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Copies the distinct data of tree into a new frozen set (O(n), without recursion);
+	the tree is not changed and can be destroyed afterwards
+	return	frozen set
+			NULL if overflow
+*/
+FROZEN* BST_Freeze(TREE* pTree);
+
+/* Deletes a frozen set and recycles memory
+*/
+void Frozen_Destroy(FROZEN* pFrozen);
+
+/* Retrieve frozen set for the requested key (branchless search with prefetch)
+	return	address of the key in the set
+			NULL not found
+*/
+int* Frozen_Retrieve(FROZEN* pFrozen, int key);
+
+/* passes back the smallest data not less than key (branchless search with prefetch)
+	return	1 success
+			0 every data is less than key
+*/
+int Frozen_LowerBound(FROZEN* pFrozen, int key, int* dataOut);
+
+/* return number of distinct data in the set
+*/
+int Frozen_Count(FROZEN* pFrozen);
+
+/* return bytes allocated for the set (head and array)
+*/
+size_t Frozen_Bytes(FROZEN* pFrozen);
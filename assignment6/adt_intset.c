@@ -0,0 +1,202 @@
+#include <stdlib.h> // calloc, free
+
+#include "adt_intset.h"
+
+#define NONE	((uint64_t)-1)
+
+/* internal function
+	return	index (key - lo) of the smallest key in the set with index >= i
+			NONE if there is none
+	climbs while the rest of the word is empty, then takes the lowest set bit
+	of each level on the way down
+*/
+static uint64_t _next(INTSET* pSet, uint64_t i) {
+	uint64_t w, m;
+	int l;
+
+	for (l = 0; l < pSet->levels; l++) {
+		w = i >> 6;
+		if (w >= pSet->nWords[l]) return NONE;
+
+		m = pSet->words[l][w] & (~(uint64_t)0 << (i & 63));
+		if (m != 0) {
+			i = (w << 6) + __builtin_ctzll(m);
+			while (l-- > 0)
+				i = (i << 6) + __builtin_ctzll(pSet->words[l][i]);
+			return i;
+		}
+		i = w + 1;
+	}
+	return NONE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Allocates an empty set for keys lo ~ hi
+	return	set pointer
+			NULL if overflow or lo > hi
+*/
+INTSET* IntSet_Create(int lo, int hi) {
+	INTSET* pSet;
+	uint64_t bits;
+	int l;
+
+	if (lo > hi) return NULL;
+
+	pSet = (INTSET*)malloc(sizeof(INTSET));
+	if (pSet == NULL) return NULL;
+
+	pSet->lo = lo;
+	pSet->hi = hi;
+	pSet->count = 0;
+
+	// a level of words for every 64 bits below, up to one word
+	bits = (uint64_t)((long long)hi - lo) + 1;
+	for (l = 0; l == 0 || pSet->nWords[l - 1] > 1; l++) {
+		pSet->nWords[l] = (bits + 63) / 64;
+		pSet->words[l] = (uint64_t*)calloc(pSet->nWords[l], sizeof(uint64_t));
+		pSet->levels = l + 1;
+		if (pSet->words[l] == NULL) {
+			pSet->levels = l;
+			IntSet_Destroy(pSet);
+			return NULL;
+		}
+		bits = pSet->nWords[l];
+	}
+	return pSet;
+}
+
+/* Deletes a set and recycles memory
+*/
+void IntSet_Destroy(INTSET* pSet) {
+	int l;
+
+	for (l = 0; l < pSet->levels; l++)
+		free(pSet->words[l]);
+	free(pSet);
+}
+
+/*
+	return 1 if a bitset over lo ~ hi is smaller than a tree of n keys
+	(at most INTSET_DENSE universe slots per key); 0 if not
+*/
+int IntSet_Dense(int lo, int hi, int n) {
+	if (lo > hi || n <= 0) return 0;
+
+	return (double)hi - lo + 1 <= (double)n * INTSET_DENSE;
+}
+
+/* Inserts key into the set
+	return	1 success
+			0 already in the set
+			-1 out of the universe
+*/
+int IntSet_Insert(INTSET* pSet, int key) {
+	uint64_t i, w, bit;
+	int l;
+
+	if (key < pSet->lo || key > pSet->hi) return -1;
+
+	i = (uint64_t)((long long)key - pSet->lo);
+	if (pSet->words[0][i >> 6] & ((uint64_t)1 << (i & 63))) return 0;
+
+	// sets the bit on each level until a word that was not empty
+	for (l = 0; l < pSet->levels; l++) {
+		w = i >> 6;
+		bit = (uint64_t)1 << (i & 63);
+		if (pSet->words[l][w] != 0) {
+			pSet->words[l][w] |= bit;
+			break;
+		}
+		pSet->words[l][w] = bit;
+		i = w;
+	}
+
+	pSet->count++;
+	return 1;
+}
+
+/* Deletes key from the set
+	return	1 success
+			0 not found
+*/
+int IntSet_Delete(INTSET* pSet, int key) {
+	uint64_t i, w;
+	int l;
+
+	if (!IntSet_Member(pSet, key)) return 0;
+
+	// clears the bit on each level until a word that is not left empty
+	i = (uint64_t)((long long)key - pSet->lo);
+	for (l = 0; l < pSet->levels; l++) {
+		w = i >> 6;
+		pSet->words[l][w] &= ~((uint64_t)1 << (i & 63));
+		if (pSet->words[l][w] != 0) break;
+		i = w;
+	}
+
+	pSet->count--;
+	return 1;
+}
+
+/*
+	return 1 if key is in the set; 0 if not
+*/
+int IntSet_Member(INTSET* pSet, int key) {
+	uint64_t i;
+
+	if (key < pSet->lo || key > pSet->hi) return 0;
+
+	i = (uint64_t)((long long)key - pSet->lo);
+	return (pSet->words[0][i >> 6] >> (i & 63)) & 1;
+}
+
+/* passes back the smallest key in the set not less than key
+	(successor of k: IntSet_Next(pSet, k + 1, &out))
+	return	1 success
+			0 no such key
+*/
+int IntSet_Next(INTSET* pSet, int key, int* keyOut) {
+	uint64_t i;
+
+	if (key > pSet->hi) return 0;
+	if (key < pSet->lo) key = pSet->lo;
+
+	i = _next(pSet, (uint64_t)((long long)key - pSet->lo));
+	if (i == NONE) return 0;
+
+	*keyOut = (int)((long long)pSet->lo + (long long)i);
+	return 1;
+}
+
+/* visits keys in the set in ascending order
+	(a word at a time; empty stretches are skipped through the upper levels)
+*/
+void IntSet_Visit(INTSET* pSet, void (*callback)(int key)) {
+	uint64_t i = _next(pSet, 0);
+	uint64_t w, m;
+
+	while (i != NONE) {
+		w = i >> 6;
+		for (m = pSet->words[0][w]; m != 0; m &= m - 1)
+			(*callback)((int)((long long)pSet->lo + (long long)((w << 6) + __builtin_ctzll(m))));
+
+		i = _next(pSet, (w + 1) << 6);
+	}
+}
+
+/* return number of keys in the set
+*/
+int IntSet_Count(INTSET* pSet) {
+	return pSet->count;
+}
+
+/* return bytes allocated for the set (head and all levels)
+*/
+size_t IntSet_Bytes(INTSET* pSet) {
+	size_t bytes = sizeof(INTSET);
+	int l;
+
+	for (l = 0; l < pSet->levels; l++)
+		bytes += sizeof(uint64_t) * pSet->nWords[l];
+	return bytes;
+}
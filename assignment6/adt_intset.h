@@ -0,0 +1,82 @@
+#include <stddef.h> // size_t
+#include <stdint.h> // uint64_t
+
+////////////////////////////////////////////////////////////////////////////////
+// Integer set over a bounded universe [lo, hi] (hierarchical bitset)
+// level 0 has a bit per key of the universe; a bit of level l + 1 is set iff
+// its 64-bit word of level l is not zero, up to a single top word
+// every operation touches one word per level (at most 6 levels for a 32-bit
+// universe) and finds set bits with count-trailing-zeros, so it runs in
+// O(log_64 U) steps; memory is about 1.016 bits per universe slot
+
+#define INTSET_LEVELS	6	// 64^6 = 2^36 covers any int universe
+
+// IntSet_Dense: a bitset pays when the universe has at most this many slots per
+// key (64 bits, a third of a BST node)
+#define INTSET_DENSE	64
+
+typedef struct
+{
+	uint64_t*	words[INTSET_LEVELS];	// words[0] is level 0 (a bit per key)
+	size_t		nWords[INTSET_LEVELS];	// words per level
+	int			levels;					// levels in use (the top one has one word)
+	int			lo;						// smallest key of the universe
+	int			hi;						// largest key of the universe
+	int			count;					// number of keys in the set
+} INTSET;
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Allocates an empty set for keys lo ~ hi
+	return	set pointer
+			NULL if overflow or lo > hi
+*/
+INTSET* IntSet_Create(int lo, int hi);
+
+/* Deletes a set and recycles memory
+*/
+void IntSet_Destroy(INTSET* pSet);
+
+/*
+	return 1 if a bitset over lo ~ hi is smaller than a tree of n keys
+	(at most INTSET_DENSE universe slots per key); 0 if not
+*/
+int IntSet_Dense(int lo, int hi, int n);
+
+/* Inserts key into the set
+	return	1 success
+			0 already in the set
+			-1 out of the universe
+*/
+int IntSet_Insert(INTSET* pSet, int key);
+
+/* Deletes key from the set
+	return	1 success
+			0 not found
+*/
+int IntSet_Delete(INTSET* pSet, int key);
+
+/*
+	return 1 if key is in the set; 0 if not
+*/
+int IntSet_Member(INTSET* pSet, int key);
+
+/* passes back the smallest key in the set not less than key
+	(successor of k: IntSet_Next(pSet, k + 1, &out))
+	return	1 success
+			0 no such key
+*/
+int IntSet_Next(INTSET* pSet, int key, int* keyOut);
+
+/* visits keys in the set in ascending order
+*/
+void IntSet_Visit(INTSET* pSet, void (*callback)(int key));
+
+/* return number of keys in the set
+*/
+int IntSet_Count(INTSET* pSet);
+
+/* return bytes allocated for the set (head and all levels)
+*/
+size_t IntSet_Bytes(INTSET* pSet);
@@ -0,0 +1,427 @@
+#include <stdlib.h> // malloc, aligned_alloc, free
+#include <limits.h> // INT_MAX
+
+#include "adt_lfbst.h"
+
+// bits of a child link
+#define FLAG		((uintptr_t)1)	// the child is a leaf being deleted
+#define TAG			((uintptr_t)2)	// the child is the sibling of a leaf being deleted
+#define ADDR(link)	((LFNODE*)((link) & ~(FLAG | TAG)))
+
+// sentinel keys above every int
+#define INF0		((long long)INT_MAX + 1)
+#define INF1		((long long)INT_MAX + 2)
+#define INF2		((long long)INT_MAX + 3)
+
+// ancestor -> successor is the last clean edge above parent -> leaf on the path
+// of a key; the edges from successor down to parent are all tagged
+typedef struct
+{
+	LFNODE*	ancestor;
+	LFNODE*	successor;
+	LFNODE*	parent;
+	LFNODE*	leaf;
+} SEEK;
+
+/* internal function
+	return	new node with key and children
+			NULL if overflow
+*/
+static LFNODE* _makeNode(long long key, LFNODE* left, LFNODE* right) {
+	LFNODE* node = (LFNODE*)malloc(sizeof(LFNODE));
+	if (node == NULL) return NULL;
+
+	node->key = key;
+	atomic_init(&node->left, (uintptr_t)left);
+	atomic_init(&node->right, (uintptr_t)right);
+	node->next = NULL;
+	return node;
+}
+
+/* internal function
+	frees a list linked through next
+*/
+static void _freeList(LFNODE* node) {
+	LFNODE* next;
+
+	for (; node != NULL; node = next) {
+		next = node->next;
+		free(node);
+	}
+}
+
+/* internal function
+	the thread starts an operation: announces the global epoch, then frees the
+	nodes it retired two or more epochs before
+*/
+static void _enter(LF_THREAD* pThread) {
+	unsigned long long epoch = atomic_load(&pThread->tree->epoch);
+	int i;
+
+	atomic_store(&pThread->state, epoch << 1 | 1);
+	atomic_thread_fence(memory_order_seq_cst); // the announcement comes before any read of the tree
+
+	for (i = 0; i < 3; i++)
+		if (pThread->retired[i].list != NULL && pThread->retired[i].epoch + 2 <= epoch) {
+			_freeList(pThread->retired[i].list);
+			pThread->retired[i].list = NULL;
+		}
+}
+
+/* internal function
+	the thread ends an operation (it holds no node any more)
+*/
+static void _leave(LF_THREAD* pThread) {
+	atomic_store_explicit(&pThread->state, 0, memory_order_release);
+}
+
+/* internal function
+	advances the global epoch if every thread in an operation has announced it
+*/
+static void _advance(LFBST* pTree) {
+	unsigned long long epoch = atomic_load(&pTree->epoch);
+	unsigned long long state;
+	int i;
+
+	for (i = 0; i < pTree->maxThreads; i++) {
+		state = atomic_load(&pTree->threads[i].state);
+		if ((state & 1) && (state >> 1) != epoch) return;
+	}
+	atomic_compare_exchange_strong(&pTree->epoch, &epoch, epoch + 1);
+}
+
+/* internal function
+	keeps a node taken out of the tree until no thread can reach it
+	the node goes to the bucket of the global epoch read after it was taken out
+	(not the epoch the thread announced, which may be one behind: a thread that
+	announced the global epoch can still hold it after one advance); the bucket
+	of the same slot three epochs before is safe to free by now
+*/
+static void _retire(LF_THREAD* pThread, LFNODE* node) {
+	unsigned long long epoch = atomic_load(&pThread->tree->epoch);
+	LF_BUCKET* bucket = &pThread->retired[epoch % 3];
+
+	if (bucket->epoch != epoch) {
+		_freeList(bucket->list);
+		bucket->list = NULL;
+		bucket->epoch = epoch;
+	}
+	node->next = bucket->list;
+	bucket->list = node;
+
+	if (++pThread->sinceAdvance >= LF_RETIRE_BATCH) {
+		pThread->sinceAdvance = 0;
+		_advance(pThread->tree);
+	}
+}
+
+/* internal function
+	return	address of the child link of node on the path of key
+*/
+static _Atomic(uintptr_t)* _child(LFNODE* node, long long key) {
+	return (key < node->key) ? &node->left : &node->right;
+}
+
+/* internal function
+	walks the path of key down to a leaf and fills the seek record
+*/
+static void _seek(LFBST* pTree, long long key, SEEK* pSeek) {
+	LFNODE* sentinel = ADDR(atomic_load_explicit(&pTree->root->left, memory_order_acquire));
+	uintptr_t parentLink, curLink;
+	LFNODE* cur;
+
+	pSeek->ancestor = pTree->root;
+	pSeek->successor = sentinel;
+	pSeek->parent = sentinel;
+	parentLink = atomic_load_explicit(&sentinel->left, memory_order_acquire);
+	pSeek->leaf = ADDR(parentLink);
+
+	curLink = atomic_load_explicit(&pSeek->leaf->left, memory_order_acquire);
+	cur = ADDR(curLink);
+
+	while (cur != NULL) {
+		if (!(parentLink & TAG)) {
+			pSeek->ancestor = pSeek->parent;
+			pSeek->successor = pSeek->leaf;
+		}
+		pSeek->parent = pSeek->leaf;
+		pSeek->leaf = cur;
+		parentLink = curLink;
+
+		curLink = atomic_load_explicit(_child(cur, key), memory_order_acquire);
+		cur = ADDR(curLink);
+	}
+}
+
+/* internal function
+	finishes a delete on the path of key: tags the edge to the sibling of the
+	flagged leaf, then swings the ancestor's edge from successor to the sibling
+	the thread whose swing succeeds retires the nodes it cut off (successor down
+	to parent, and the flagged leaf beside each)
+	return	1 the swing succeeded
+			0 the tree changed (seek again)
+*/
+static int _cleanup(LF_THREAD* pThread, long long key, SEEK* pSeek) {
+	_Atomic(uintptr_t)* successorLink = _child(pSeek->ancestor, key);
+	_Atomic(uintptr_t)* childLink = _child(pSeek->parent, key);
+	_Atomic(uintptr_t)* siblingLink;
+	uintptr_t expected = (uintptr_t)pSeek->successor;
+	uintptr_t sibling;
+	LFNODE* cur;
+	LFNODE* next;
+
+	siblingLink = (childLink == &pSeek->parent->left) ? &pSeek->parent->right : &pSeek->parent->left;
+
+	// the leaf on the path of key is not flagged: the other one is being deleted
+	if (!(atomic_load(childLink) & FLAG)) siblingLink = childLink;
+
+	sibling = atomic_fetch_or(siblingLink, TAG);
+
+	// the sibling keeps its flag (it may be under deletion too), not the tag
+	if (!atomic_compare_exchange_strong(successorLink, &expected, sibling & ~TAG)) return 0;
+
+	for (cur = pSeek->successor; cur != pSeek->parent; cur = next) {
+		next = ADDR(atomic_load(_child(cur, key)));
+		_retire(pThread, ADDR(atomic_load(_child(cur, key) == &cur->left ? &cur->right : &cur->left)));
+		_retire(pThread, cur);
+	}
+	_retire(pThread, ADDR(atomic_load(siblingLink == &cur->left ? &cur->right : &cur->left)));
+	_retire(pThread, cur);
+	return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Allocates an empty set for up to maxThreads handles (1 ~ LF_MAX_THREADS)
+	return	set pointer
+			NULL if overflow
+*/
+LFBST* LFBST_Create(int maxThreads) {
+	LFBST* pTree;
+	LFNODE* leaf[3];
+	LFNODE* sentinel;
+	int i, j;
+
+	if (maxThreads < 1 || maxThreads > LF_MAX_THREADS) return NULL;
+
+	pTree = (LFBST*)malloc(sizeof(LFBST));
+	if (pTree == NULL) return NULL;
+
+	// root (INF2) has the sentinel (INF1) on the left; keys go below the sentinel's left leaf (INF0)
+	leaf[0] = _makeNode(INF0, NULL, NULL);
+	leaf[1] = _makeNode(INF1, NULL, NULL);
+	leaf[2] = _makeNode(INF2, NULL, NULL);
+	sentinel = _makeNode(INF1, leaf[0], leaf[1]);
+	pTree->root = _makeNode(INF2, sentinel, leaf[2]);
+	pTree->threads = (LF_THREAD*)aligned_alloc(LF_CACHE_LINE, sizeof(LF_THREAD) * maxThreads);
+	pTree->maxThreads = maxThreads;
+	atomic_init(&pTree->epoch, 0);
+
+	if (!leaf[0] || !leaf[1] || !leaf[2] || !sentinel || !pTree->root || !pTree->threads) {
+		for (i = 0; i < 3; i++) free(leaf[i]);
+		free(sentinel);
+		free(pTree->root);
+		free(pTree->threads);
+		free(pTree);
+		return NULL;
+	}
+
+	for (i = 0; i < maxThreads; i++) {
+		atomic_init(&pTree->threads[i].state, 0);
+		atomic_init(&pTree->threads[i].attached, 0);
+		pTree->threads[i].tree = pTree;
+		pTree->threads[i].sinceAdvance = 0;
+		for (j = 0; j < 3; j++) {
+			pTree->threads[i].retired[j].epoch = j;
+			pTree->threads[i].retired[j].list = NULL;
+		}
+	}
+	return pTree;
+}
+
+/* Deletes a set and recycles memory; no handle may be in use any more
+*/
+void LFBST_Destroy(LFBST* pTree) {
+	LFNODE* stack = pTree->root;
+	LFNODE* node;
+	int i, j;
+
+	// a stack linked through next (no node of the tree is on a retired list)
+	if (stack != NULL) stack->next = NULL;
+	while (stack != NULL) {
+		node = stack;
+		stack = node->next;
+
+		if (ADDR(atomic_load(&node->left)) != NULL) {
+			ADDR(atomic_load(&node->left))->next = stack;
+			stack = ADDR(atomic_load(&node->left));
+		}
+		if (ADDR(atomic_load(&node->right)) != NULL) {
+			ADDR(atomic_load(&node->right))->next = stack;
+			stack = ADDR(atomic_load(&node->right));
+		}
+		free(node);
+	}
+
+	for (i = 0; i < pTree->maxThreads; i++)
+		for (j = 0; j < 3; j++)
+			_freeList(pTree->threads[i].retired[j].list);
+
+	free(pTree->threads);
+	free(pTree);
+}
+
+/* Takes a handle for the calling thread
+	return	handle
+			NULL if all handles are taken
+*/
+LF_THREAD* LFBST_Attach(LFBST* pTree) {
+	int i, expected;
+
+	for (i = 0; i < pTree->maxThreads; i++) {
+		expected = 0;
+		if (atomic_compare_exchange_strong(&pTree->threads[i].attached, &expected, 1))
+			return &pTree->threads[i];
+	}
+	return NULL;
+}
+
+/* Gives the handle back (its retired nodes are freed later by the set)
+*/
+void LFBST_Detach(LF_THREAD* pThread) {
+	atomic_store(&pThread->state, 0);
+	atomic_store(&pThread->attached, 0);
+}
+
+/* Inserts data into the set (lock-free)
+	return	1 success
+			0 already in the set
+			-1 overflow
+*/
+int LFBST_Insert(LF_THREAD* pThread, int data) {
+	LFNODE* newLeaf = _makeNode(data, NULL, NULL);
+	LFNODE* newInner = _makeNode(data, NULL, NULL);
+	_Atomic(uintptr_t)* childLink;
+	uintptr_t expected;
+	SEEK seek;
+
+	if (newLeaf == NULL || newInner == NULL) {
+		free(newLeaf);
+		free(newInner);
+		return -1;
+	}
+
+	_enter(pThread);
+	for (;;) {
+		_seek(pThread->tree, data, &seek);
+
+		if (seek.leaf->key == data) {
+			_leave(pThread);
+			free(newLeaf);
+			free(newInner);
+			return 0;
+		}
+
+		// the new inner node routes between the new leaf and the leaf found
+		if (data < seek.leaf->key) {
+			newInner->key = seek.leaf->key;
+			atomic_store_explicit(&newInner->left, (uintptr_t)newLeaf, memory_order_relaxed);
+			atomic_store_explicit(&newInner->right, (uintptr_t)seek.leaf, memory_order_relaxed);
+		}
+		else {
+			newInner->key = data;
+			atomic_store_explicit(&newInner->left, (uintptr_t)seek.leaf, memory_order_relaxed);
+			atomic_store_explicit(&newInner->right, (uintptr_t)newLeaf, memory_order_relaxed);
+		}
+
+		childLink = _child(seek.parent, data);
+		expected = (uintptr_t)seek.leaf;
+		if (atomic_compare_exchange_strong(childLink, &expected, (uintptr_t)newInner)) break;
+
+		// a delete holds the edge: help it, then try again
+		if (ADDR(expected) == seek.leaf && (expected & (FLAG | TAG)))
+			_cleanup(pThread, data, &seek);
+	}
+	_leave(pThread);
+	return 1;
+}
+
+/* Deletes dltKey from the set (lock-free)
+	return	1 success
+			0 not found
+*/
+int LFBST_Delete(LF_THREAD* pThread, int dltKey) {
+	_Atomic(uintptr_t)* childLink;
+	LFNODE* leaf = NULL;
+	uintptr_t expected;
+	SEEK seek;
+
+	_enter(pThread);
+	for (;;) {
+		_seek(pThread->tree, dltKey, &seek);
+
+		// injection: flag the edge to the leaf (the delete takes effect here)
+		if (leaf == NULL) {
+			if (seek.leaf->key != dltKey) break;
+
+			childLink = _child(seek.parent, dltKey);
+			expected = (uintptr_t)seek.leaf;
+			if (atomic_compare_exchange_strong(childLink, &expected, expected | FLAG)) {
+				leaf = seek.leaf;
+				if (_cleanup(pThread, dltKey, &seek)) break;
+			}
+			else if (ADDR(expected) == seek.leaf && (expected & (FLAG | TAG)))
+				_cleanup(pThread, dltKey, &seek);
+		}
+		// cleanup: until the leaf is off the path (by this thread or a helper)
+		else if (seek.leaf != leaf || _cleanup(pThread, dltKey, &seek))
+			break;
+	}
+	_leave(pThread);
+	return leaf != NULL;
+}
+
+/* Retrieve set for the requested key (lock-free, no CAS)
+	return	1 found (no address: the leaf may be freed once the call returns)
+			0 not found
+*/
+int LFBST_Retrieve(LF_THREAD* pThread, int key) {
+	LFNODE* cur = pThread->tree->root;
+	LFNODE* next;
+	int found;
+
+	_enter(pThread);
+	while ((next = ADDR(atomic_load_explicit(_child(cur, key), memory_order_acquire))) != NULL)
+		cur = next;
+	found = (cur->key == key);
+	_leave(pThread);
+
+	return found;
+}
+
+/* return number of data in the set (O(n); only while no thread updates it)
+*/
+int LFBST_Count(LFBST* pTree) {
+	LFNODE* stack = pTree->root;
+	LFNODE* node;
+	LFNODE* child;
+	int count = 0;
+
+	stack->next = NULL;
+	while (stack != NULL) {
+		node = stack;
+		stack = node->next;
+
+		child = ADDR(atomic_load(&node->left));
+		if (child == NULL) {
+			count += (node->key < INF0);
+			continue;
+		}
+		child->next = stack;
+		stack = child;
+
+		child = ADDR(atomic_load(&node->right));
+		child->next = stack;
+		stack = child;
+	}
+	return count;
+}
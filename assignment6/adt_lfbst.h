@@ -0,0 +1,102 @@
+#include <stddef.h> // size_t
+#include <stdint.h> // uintptr_t
+#include <stdatomic.h> // atomic_ullong
+
+////////////////////////////////////////////////////////////////////////////////
+// Lock-free integer set (external BST of Natarajan and Mittal) for many threads
+// keys live in leaves; inner nodes only route a search, so an insert adds a leaf
+// and an inner node with one CAS, and a delete takes a leaf and its parent out
+// the low bits of a child link mark its edge: a flagged edge leads to a leaf
+// being deleted and a tagged edge leads to its sibling; neither can change
+// again, so any thread that meets them can finish the delete (no thread waits
+// for another)
+// removed nodes are freed by epochs: a thread announces the global epoch while
+// it is in an operation, and a node retired in epoch e is freed once the epoch
+// reaches e + 2 (every thread has left the operations that could see it)
+// every thread works through its own handle (LFBST_Attach)
+
+#define LF_MAX_THREADS	256	// handles per set (LFBST_Create)
+#define LF_RETIRE_BATCH	64	// retired nodes between attempts to advance the epoch
+#define LF_CACHE_LINE	64
+
+typedef struct lfnode
+{
+	long long			key;	// inner: routes keys < key left; leaf: the data
+	_Atomic(uintptr_t)	left;	// child with flag and tag bits (0 in a leaf)
+	_Atomic(uintptr_t)	right;
+	struct lfnode*		next;	// retired list
+} LFNODE;
+
+typedef struct
+{
+	unsigned long long	epoch;
+	LFNODE*				list;
+} LF_BUCKET;
+
+typedef struct lfbst LFBST;
+
+// per-thread handle (one cache line apart from the others)
+typedef struct
+{
+	_Alignas(LF_CACHE_LINE)
+	atomic_ullong	state;		// announced epoch << 1 | 1 while in an operation, 0 otherwise
+								// (64 bits: the epoch never wraps or loses its top bit)
+	atomic_int		attached;
+	LFBST*			tree;
+	LF_BUCKET		retired[3];	// nodes retired in the last three epochs it saw
+	int				sinceAdvance;
+} LF_THREAD;
+
+struct lfbst
+{
+	LFNODE*			root;		// sentinel: the real tree is below root->left->left
+	atomic_ullong	epoch;
+	int				maxThreads;
+	LF_THREAD*		threads;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Allocates an empty set for up to maxThreads handles (1 ~ LF_MAX_THREADS)
+	return	set pointer
+			NULL if overflow
+*/
+LFBST* LFBST_Create(int maxThreads);
+
+/* Deletes a set and recycles memory; no handle may be in use any more
+*/
+void LFBST_Destroy(LFBST* pTree);
+
+/* Takes a handle for the calling thread
+	return	handle
+			NULL if all handles are taken
+*/
+LF_THREAD* LFBST_Attach(LFBST* pTree);
+
+/* Gives the handle back (its retired nodes are freed later by the set)
+*/
+void LFBST_Detach(LF_THREAD* pThread);
+
+/* Inserts data into the set (lock-free)
+	return	1 success
+			0 already in the set
+			-1 overflow
+*/
+int LFBST_Insert(LF_THREAD* pThread, int data);
+
+/* Deletes dltKey from the set (lock-free)
+	return	1 success
+			0 not found
+*/
+int LFBST_Delete(LF_THREAD* pThread, int dltKey);
+
+/* Retrieve set for the requested key (lock-free, no CAS)
+	return	1 found (no address: the leaf may be freed once the call returns)
+			0 not found
+*/
+int LFBST_Retrieve(LF_THREAD* pThread, int key);
+
+/* return number of data in the set (O(n); only while no thread updates it)
+*/
+int LFBST_Count(LFBST* pTree);
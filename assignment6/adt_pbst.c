@@ -0,0 +1,323 @@
+#include <stdlib.h> // malloc, free, rand
+
+#include "adt_pbst.h"
+
+/* internal function
+	treap priority of data (max-heap order); a hash of the data with the set seed,
+	so that every copy of a node has the same priority
+*/
+static unsigned int _priority(PBST* pTree, PNODE* node) {
+	unsigned int x = (unsigned int)node->data ^ pTree->seed;
+
+	x ^= x >> 16;
+	x *= 0x7feb352dU;
+	x ^= x >> 15;
+	x *= 0x846ca68bU;
+	x ^= x >> 16;
+	return x;
+}
+
+/* internal function
+	adds a holder to the subtree
+	return	node
+*/
+static PNODE* _ref(PNODE* node) {
+	if (node != NULL) atomic_fetch_add(&node->refs, 1);
+	return node;
+}
+
+/* internal function
+	drops a holder of the subtree; a node without holders is freed and drops
+	its children in turn
+*/
+static void _release(PNODE* node) {
+	PNODE* right;
+
+	while (node != NULL && atomic_fetch_sub(&node->refs, 1) == 1) {
+		_release(node->left);
+		right = node->right;
+		free(node);
+		node = right;
+	}
+}
+
+/* internal function
+	allocates a node that takes over the holds on left and right
+	once *ok is 0 (overflow here or before), nothing is allocated and the holds
+	are dropped, so a failed update unwinds without leaks
+	return	new node
+			NULL if overflow
+*/
+static PNODE* _node(int data, PNODE* left, PNODE* right, int* ok) {
+	PNODE* node = NULL;
+
+	if (*ok) node = (PNODE*)malloc(sizeof(PNODE));
+	if (node == NULL) {
+		*ok = 0;
+		_release(left);
+		_release(right);
+		return NULL;
+	}
+
+	node->left = left;
+	node->right = right;
+	node->data = data;
+	atomic_init(&node->refs, 1);
+	return node;
+}
+
+/* internal function
+	inserts newData into a copy of the path (the copies are not published yet,
+	so the treap rotations can change them in place)
+	return	root of the new subtree
+			NULL if overflow
+*/
+static PNODE* _insert(PBST* pTree, PNODE* root, int newData, int* ok) {
+	PNODE* node;
+	PNODE* pivot;
+
+	if (root == NULL) return _node(newData, NULL, NULL, ok);
+
+	if (root->data > newData) {
+		node = _node(root->data, _insert(pTree, root->left, newData, ok), _ref(root->right), ok);
+		if (node != NULL && _priority(pTree, node->left) > _priority(pTree, node)) {
+			pivot = node->left;
+			node->left = pivot->right;
+			pivot->right = node;
+			node = pivot;
+		}
+	}
+	else {
+		node = _node(root->data, _ref(root->left), _insert(pTree, root->right, newData, ok), ok);
+		if (node != NULL && _priority(pTree, node->right) > _priority(pTree, node)) {
+			pivot = node->right;
+			node->right = pivot->left;
+			pivot->left = node;
+			node = pivot;
+		}
+	}
+	return node;
+}
+
+/* internal function
+	joins two treaps (all keys of left < all keys of right) into new nodes along
+	the inner spines; left and right are not changed
+	return	root of the joined treap
+			NULL if empty or overflow
+*/
+static PNODE* _join(PBST* pTree, PNODE* left, PNODE* right, int* ok) {
+	if (left == NULL) return _ref(right);
+	if (right == NULL) return _ref(left);
+
+	if (_priority(pTree, left) > _priority(pTree, right))
+		return _node(left->data, _ref(left->left), _join(pTree, left->right, right, ok), ok);
+	return _node(right->data, _join(pTree, left, right->left, ok), _ref(right->right), ok);
+}
+
+/* internal function
+	deletes dltKey (which must be in the subtree) from a copy of the path
+	return	root of the new subtree
+			NULL if empty or overflow
+*/
+static PNODE* _delete(PBST* pTree, PNODE* root, int dltKey, int* ok) {
+	if (root->data > dltKey)
+		return _node(root->data, _delete(pTree, root->left, dltKey, ok), _ref(root->right), ok);
+	if (root->data < dltKey)
+		return _node(root->data, _ref(root->left), _delete(pTree, root->right, dltKey, ok), ok);
+	return _join(pTree, root->left, root->right, ok);
+}
+
+/* internal function
+	drops the writer's reference to the replaced versions, unless a reader is
+	between reading current and pinning it (it may be pinning one of them)
+	force skips the check (no reader left)
+*/
+static void _reclaim(PBST* pTree, int force) {
+	PVERSION* next;
+
+	if (!force && atomic_load(&pTree->pinning) != 0) return;
+
+	while (pTree->retired != NULL) {
+		next = pTree->retired->next;
+		PBST_Unpin(pTree->retired);
+		pTree->retired = next;
+	}
+}
+
+/* internal function
+	makes root the current version and retires the one it replaces
+	return	1 success
+			-1 overflow (root is dropped)
+*/
+static int _publish(PBST* pTree, PNODE* root, int count) {
+	PVERSION* pVersion = (PVERSION*)malloc(sizeof(PVERSION));
+	PVERSION* old;
+
+	if (pVersion == NULL) {
+		_release(root);
+		return -1;
+	}
+	pVersion->root = root;
+	pVersion->count = count;
+	pVersion->next = NULL;
+	atomic_init(&pVersion->refs, 1); // the writer's
+
+	old = atomic_exchange(&pTree->current, pVersion);
+	old->next = pTree->retired;
+	pTree->retired = old;
+
+	// a reader that starts pinning from now on sees the new version
+	_reclaim(pTree, 0);
+	return 1;
+}
+
+/* internal function
+	visits the subtree in order
+*/
+static void _visit(const PNODE* root, void (*callback)(int data, void* arg), void* arg) {
+	while (root != NULL) {
+		_visit(root->left, callback, arg);
+		(*callback)(root->data, arg);
+		root = root->right;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Allocates an empty set (its first version is empty)
+	return	set pointer
+			NULL if overflow
+*/
+PBST* PBST_Create(void) {
+	PBST* pTree = (PBST*)malloc(sizeof(PBST));
+	PVERSION* pVersion = (PVERSION*)malloc(sizeof(PVERSION));
+
+	if (pTree == NULL || pVersion == NULL) {
+		free(pTree);
+		free(pVersion);
+		return NULL;
+	}
+
+	pVersion->root = NULL;
+	pVersion->count = 0;
+	pVersion->next = NULL;
+	atomic_init(&pVersion->refs, 1);
+
+	atomic_init(&pTree->current, pVersion);
+	atomic_init(&pTree->pinning, 0);
+	pTree->retired = NULL;
+	pTree->seed = (unsigned int)rand() * 2654435761U;
+	return pTree;
+}
+
+/* Deletes a set and recycles memory; no version may be pinned any more
+*/
+void PBST_Destroy(PBST* pTree) {
+	_reclaim(pTree, 1);
+	PBST_Unpin(atomic_load(&pTree->current));
+	free(pTree);
+}
+
+/* Inserts data as a new version (writer only)
+	return	1 success
+			0 already in the set
+			-1 overflow
+*/
+int PBST_Insert(PBST* pTree, int data) {
+	PVERSION* cur = atomic_load(&pTree->current);
+	PNODE* root;
+	int ok = 1;
+
+	if (PVersion_Member(cur, data)) return 0;
+
+	root = _insert(pTree, cur->root, data, &ok);
+	if (!ok) return -1;
+
+	return _publish(pTree, root, cur->count + 1);
+}
+
+/* Deletes dltKey as a new version (writer only)
+	return	1 success
+			0 not found
+			-1 overflow
+*/
+int PBST_Delete(PBST* pTree, int dltKey) {
+	PVERSION* cur = atomic_load(&pTree->current);
+	PNODE* root;
+	int ok = 1;
+
+	if (!PVersion_Member(cur, dltKey)) return 0;
+
+	root = _delete(pTree, cur->root, dltKey, &ok);
+	if (!ok) return -1;
+
+	return _publish(pTree, root, cur->count - 1);
+}
+
+/*
+	return 1 if key is in the current version; 0 if not (writer only)
+*/
+int PBST_Member(PBST* pTree, int key) {
+	return PVersion_Member(atomic_load(&pTree->current), key);
+}
+
+/* return number of data in the current version (writer only)
+*/
+int PBST_Count(PBST* pTree) {
+	return atomic_load(&pTree->current)->count;
+}
+
+/* Pins the current version, which stays unchanged until PBST_Unpin
+	(any thread; O(1), no lock)
+	return	version
+*/
+const PVERSION* PBST_Pin(PBST* pTree) {
+	PVERSION* pVersion;
+
+	// the writer keeps its reference to current until pinning is 0 again
+	atomic_fetch_add(&pTree->pinning, 1);
+	pVersion = atomic_load(&pTree->current);
+	atomic_fetch_add(&pVersion->refs, 1);
+	atomic_fetch_sub(&pTree->pinning, 1);
+
+	return pVersion;
+}
+
+/* Unpins a version; the last pin of a replaced version frees it
+*/
+void PBST_Unpin(const PVERSION* pVersion) {
+	PVERSION* version = (PVERSION*)pVersion;
+
+	if (atomic_fetch_sub(&version->refs, 1) != 1) return;
+
+	_release(version->root);
+	free(version);
+}
+
+/*
+	return 1 if key is in the version; 0 if not
+*/
+int PVersion_Member(const PVERSION* pVersion, int key) {
+	const PNODE* cur = pVersion->root;
+
+	while (cur != NULL) {
+		if (cur->data == key) return 1;
+
+		if (cur->data > key)
+			cur = cur->left;
+		else
+			cur = cur->right;
+	}
+	return 0;
+}
+
+/* return number of data in the version
+*/
+int PVersion_Count(const PVERSION* pVersion) {
+	return pVersion->count;
+}
+
+/* visits data of the version in order
+*/
+void PVersion_Visit(const PVERSION* pVersion, void (*callback)(int data, void* arg), void* arg) {
+	_visit(pVersion->root, callback, arg);
+}
@@ -0,0 +1,97 @@
+#include <stddef.h> // size_t
+#include <stdatomic.h> // atomic_int
+
+////////////////////////////////////////////////////////////////////////////////
+// Persistent integer set (path-copying treap) for snapshot readers
+// an update never changes a published node: it copies the path from the root to
+// the changed place (O(height) new nodes), rebalances the copies, and publishes
+// the new root as a new version; unchanged subtrees are shared by every version
+// that reaches them, and each node counts the parents and versions holding it
+// one writer thread updates the set; any number of reader threads pin the
+// current version (O(1), no lock) and read it while the writer goes on
+// a version dies with its last pin (and the writer's reference, which is
+// dropped once the version is replaced and no pin is in progress); then the
+// nodes only it held are freed
+
+typedef struct pnode
+{
+	struct pnode*	left;
+	struct pnode*	right;
+	int				data;
+	atomic_int		refs;	// parents and versions holding the node
+} PNODE;
+
+typedef struct pversion
+{
+	PNODE*				root;
+	int					count;	// number of data in the version
+	atomic_int			refs;	// pins (and the writer's reference while it is kept)
+	struct pversion*	next;	// writer: replaced versions waiting to be dropped
+} PVERSION;
+
+typedef struct
+{
+	_Atomic(PVERSION*)	current;	// newest version
+	atomic_int			pinning;	// readers between reading current and pinning it
+	PVERSION*			retired;	// replaced versions the writer still holds
+	unsigned int		seed;		// treap priority seed
+} PBST;
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Allocates an empty set (its first version is empty)
+	return	set pointer
+			NULL if overflow
+*/
+PBST* PBST_Create(void);
+
+/* Deletes a set and recycles memory; no version may be pinned any more
+*/
+void PBST_Destroy(PBST* pTree);
+
+/* Inserts data as a new version (writer only)
+	return	1 success
+			0 already in the set
+			-1 overflow
+*/
+int PBST_Insert(PBST* pTree, int data);
+
+/* Deletes dltKey as a new version (writer only)
+	return	1 success
+			0 not found
+			-1 overflow
+*/
+int PBST_Delete(PBST* pTree, int dltKey);
+
+/*
+	return 1 if key is in the current version; 0 if not (writer only)
+*/
+int PBST_Member(PBST* pTree, int key);
+
+/* return number of data in the current version (writer only)
+*/
+int PBST_Count(PBST* pTree);
+
+/* Pins the current version, which stays unchanged until PBST_Unpin
+	(any thread; O(1), no lock)
+	return	version
+*/
+const PVERSION* PBST_Pin(PBST* pTree);
+
+/* Unpins a version; the last pin of a replaced version frees it
+*/
+void PBST_Unpin(const PVERSION* pVersion);
+
+/*
+	return 1 if key is in the version; 0 if not
+*/
+int PVersion_Member(const PVERSION* pVersion, int key);
+
+/* return number of data in the version
+*/
+int PVersion_Count(const PVERSION* pVersion);
+
+/* visits data of the version in order
+*/
+void PVersion_Visit(const PVERSION* pVersion, void (*callback)(int data, void* arg), void* arg);
@@ -0,0 +1,272 @@
+#include <stdlib.h> // malloc, realloc, free
+#include <string.h> // memmove
+
+#include "adt_rmi.h"
+
+/* internal function
+	stage 1: interpolates key between the smallest and largest keys
+	return	index of the stage 2 model for key
+*/
+static int _route(RMI* pIndex, int key) {
+	double m = ((double)key - pIndex->keys[0]) * pIndex->scale;
+
+	if (m < 0) return 0;
+	if (m >= pIndex->nModels) return pIndex->nModels - 1;
+	return (int)m;
+}
+
+/* internal function
+	stage 2: position of key predicted by a model (clamped to the keys, as a
+	key routed to a model may be far from its keys)
+*/
+static int _predict(RMI* pIndex, const RMI_MODEL* model, int key) {
+	double pos = model->start + model->slope * ((double)key - model->first);
+
+	if (pos < 0) return 0;
+	if (pos > pIndex->n - 1) return pIndex->n - 1;
+	return (int)pos;
+}
+
+/* internal function
+	makes room for the models of n keys (the models in place are kept)
+	return	1 success
+			0 overflow (the index is not changed)
+*/
+static int _reserveModels(RMI* pIndex, int n) {
+	RMI_MODEL* models;
+
+	models = (RMI_MODEL*)realloc(pIndex->models, sizeof(RMI_MODEL) * (n / RMI_KEYS_PER_MODEL + 1));
+	if (models == NULL) return 0;
+
+	pIndex->models = models;
+	return 1;
+}
+
+/* internal function
+	fits the models to keys[0] ~ keys[n - 1]: routes every key, draws each model's
+	line through its first and last keys and records the worst errors
+	(room for the models is made by _reserveModels first)
+*/
+static void _fit(RMI* pIndex) {
+	RMI_MODEL* models = pIndex->models;
+	RMI_MODEL* m;
+	int* keys = pIndex->keys;
+	int n = pIndex->n;
+	int nModels = n / RMI_KEYS_PER_MODEL + 1;
+	int i, j, s, e, err;
+
+	pIndex->nModels = nModels;
+	pIndex->scale = (n > 0) ? nModels / ((double)keys[n - 1] - keys[0] + 1) : 0.0;
+
+	// keys routed to model j are keys[s] ~ keys[e - 1] (routing is monotonic)
+	s = 0;
+	for (j = 0; j < nModels; j++) {
+		for (e = s; e < n && _route(pIndex, keys[e]) == j; e++)
+			;
+
+		m = &models[j];
+		m->start = s;
+		m->first = (e > s) ? keys[s] : 0;
+		m->slope = (e - 1 > s) ? (e - 1 - s) / ((double)keys[e - 1] - keys[s]) : 0.0;
+		m->errLo = 0;
+		m->errHi = 0;
+
+		for (i = s; i < e; i++) {
+			err = i - _predict(pIndex, m, keys[i]);
+			if (err > m->errHi) m->errHi = err;
+			if (-err > m->errLo) m->errLo = -err;
+		}
+		s = e;
+	}
+}
+
+/* internal function
+	branchless binary search: halves the range with a conditional add instead
+	of a branch, so the loop runs the same log2(n) steps for any key
+	return	position of the first key not less than key in keys[0] ~ keys[n - 1]
+			n if there is none
+*/
+static int _lowerBound(const int* keys, int n, int key) {
+	const int* base = keys;
+	int half;
+
+	if (n == 0) return 0;
+
+	while (n > 1) {
+		half = n / 2;
+		base += (base[half - 1] < key) * half;
+		n -= half;
+	}
+	return (int)(base - keys) + (*base < key);
+}
+
+/* internal function
+	merges the delta buffer into the keys and refits the models
+	(the delta keys are not in keys, so there are n + nDelta keys after)
+	return	1 success
+			0 overflow (the index is not changed)
+*/
+static int _merge(RMI* pIndex) {
+	int* keys = (int*)malloc(sizeof(int) * ((size_t)pIndex->n + pIndex->nDelta + 1));
+	int i = 0, j = 0, k = 0;
+
+	if (keys == NULL) return 0;
+	if (!_reserveModels(pIndex, pIndex->n + pIndex->nDelta)) {
+		free(keys);
+		return 0;
+	}
+
+	while (i < pIndex->n || j < pIndex->nDelta) {
+		if (j == pIndex->nDelta || (i < pIndex->n && pIndex->keys[i] < pIndex->delta[j]))
+			keys[k++] = pIndex->keys[i++];
+		else
+			keys[k++] = pIndex->delta[j++];
+	}
+
+	free(pIndex->keys);
+	pIndex->keys = keys;
+	pIndex->n = k;
+	pIndex->nDelta = 0;
+	_fit(pIndex);
+	return 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/* Builds an index of keys[0] ~ keys[n - 1] (ascending order; duplicates are kept once)
+	the keys are copied
+	return	index pointer
+			NULL if overflow or keys not sorted
+*/
+RMI* RMI_Create(const int* keys, int n) {
+	RMI* pIndex;
+	int i;
+
+	if (n < 0) return NULL;
+	for (i = 1; i < n; i++)
+		if (keys[i - 1] > keys[i]) return NULL;
+
+	pIndex = (RMI*)malloc(sizeof(RMI));
+	if (pIndex == NULL) return NULL;
+
+	pIndex->keys = (int*)malloc(sizeof(int) * ((size_t)n + 1));
+	pIndex->delta = (int*)malloc(sizeof(int) * RMI_DELTA_MIN);
+	pIndex->deltaCapacity = RMI_DELTA_MIN;
+	pIndex->nDelta = 0;
+	pIndex->models = NULL;
+	pIndex->n = 0;
+
+	if (pIndex->keys == NULL || pIndex->delta == NULL) {
+		RMI_Destroy(pIndex);
+		return NULL;
+	}
+
+	for (i = 0; i < n; i++)
+		if (i == 0 || keys[i] != keys[i - 1])
+			pIndex->keys[pIndex->n++] = keys[i];
+
+	if (!_reserveModels(pIndex, pIndex->n)) {
+		RMI_Destroy(pIndex);
+		return NULL;
+	}
+	_fit(pIndex);
+	return pIndex;
+}
+
+/* Deletes an index and recycles memory
+*/
+void RMI_Destroy(RMI* pIndex) {
+	free(pIndex->keys);
+	free(pIndex->models);
+	free(pIndex->delta);
+	free(pIndex);
+}
+
+/* Inserts key into the delta buffer (merged into the model when it fills up)
+	return	1 success
+			0 already in the index
+			-1 overflow
+*/
+int RMI_Insert(RMI* pIndex, int key) {
+	int limit = pIndex->n / RMI_DELTA_RATIO;
+	int* delta;
+	int pos;
+
+	if (RMI_Retrieve(pIndex, key) != NULL) return 0;
+
+	if (pIndex->nDelta == pIndex->deltaCapacity) {
+		delta = (int*)realloc(pIndex->delta, sizeof(int) * pIndex->deltaCapacity * 2);
+		if (delta == NULL) return -1;
+
+		pIndex->delta = delta;
+		pIndex->deltaCapacity *= 2;
+	}
+
+	pos = _lowerBound(pIndex->delta, pIndex->nDelta, key);
+	memmove(&pIndex->delta[pos + 1], &pIndex->delta[pos], sizeof(int) * (pIndex->nDelta - pos));
+	pIndex->delta[pos] = key;
+	pIndex->nDelta++;
+
+	if (pIndex->nDelta > (limit > RMI_DELTA_MIN ? limit : RMI_DELTA_MIN))
+		if (!_merge(pIndex)) return -1;
+	return 1;
+}
+
+/* Retrieve index for the requested key
+	return	address of the key (valid until the next insertion)
+			NULL not found
+*/
+int* RMI_Retrieve(RMI* pIndex, int key) {
+	const RMI_MODEL* m;
+	int lo, hi, pos;
+
+	if (pIndex->n > 0) {
+		m = &pIndex->models[_route(pIndex, key)];
+		pos = _predict(pIndex, m, key);
+
+		// only the error window of the model can hold key
+		lo = pos - m->errLo;
+		hi = pos + m->errHi;
+		if (lo < 0) lo = 0;
+		if (hi > pIndex->n - 1) hi = pIndex->n - 1;
+
+		if (lo <= hi) {
+			pos = lo + _lowerBound(pIndex->keys + lo, hi - lo + 1, key);
+			if (pos <= hi && pIndex->keys[pos] == key) return &pIndex->keys[pos];
+		}
+	}
+
+	if (pIndex->nDelta > 0) {
+		pos = _lowerBound(pIndex->delta, pIndex->nDelta, key);
+		if (pos < pIndex->nDelta && pIndex->delta[pos] == key) return &pIndex->delta[pos];
+	}
+	return NULL;
+}
+
+/* return number of keys in the index (delta buffer included)
+*/
+int RMI_Count(RMI* pIndex) {
+	return pIndex->n + pIndex->nDelta;
+}
+
+/* return average error window of the models (positions searched per lookup)
+*/
+double RMI_AvgWindow(RMI* pIndex) {
+	double sum = 0.0;
+	int j, end;
+
+	if (pIndex->n == 0) return 0.0;
+
+	// weighted by the keys of each model
+	for (j = 0; j < pIndex->nModels; j++) {
+		end = (j + 1 < pIndex->nModels) ? pIndex->models[j + 1].start : pIndex->n;
+		sum += (double)(end - pIndex->models[j].start) * (pIndex->models[j].errLo + pIndex->models[j].errHi + 1);
+	}
+	return sum / pIndex->n;
+}
+
+/* return bytes allocated for the index (keys, models and delta buffer)
+*/
+size_t RMI_Bytes(RMI* pIndex) {
+	return sizeof(RMI) + sizeof(int) * ((size_t)pIndex->n + 1) + sizeof(RMI_MODEL) * (size_t)pIndex->nModels
+		+ sizeof(int) * (size_t)pIndex->deltaCapacity;
+}
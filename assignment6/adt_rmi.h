@@ -0,0 +1,74 @@
+#include <stddef.h> // size_t
+
+////////////////////////////////////////////////////////////////////////////////
+// Learned index (two-stage recursive model index) over a sorted int key set
+// stage 1 interpolates a key into one of the stage 2 models; each stage 2 model
+// is a line through its first and last keys that predicts the position of a key
+// in the sorted array, with the largest errors of its keys kept at build time,
+// so a lookup is two multiply-adds and a binary search of the error window only
+// keys inserted after the build go to a small sorted delta buffer, which is
+// merged (and the models refit) once it outgrows RMI_DELTA_RATIO of the keys
+
+#define RMI_KEYS_PER_MODEL	32	// stage 2 models: one per this many keys
+#define RMI_DELTA_MIN		64	// delta buffer size merged at least
+#define RMI_DELTA_RATIO		32	// delta buffer is merged above n / RMI_DELTA_RATIO
+
+typedef struct
+{
+	double	slope;		// position = start + slope * (key - first key)
+	int		first;		// first key routed to the model
+	int		start;		// position of the first key
+	int		errLo;		// largest (predicted - actual) position of its keys
+	int		errHi;		// largest (actual - predicted) position of its keys
+} RMI_MODEL;
+
+typedef struct
+{
+	int*		keys;		// sorted distinct keys
+	int			n;
+	RMI_MODEL*	models;		// stage 2
+	int			nModels;
+	double		scale;		// stage 1: model = (key - keys[0]) * scale
+	int*		delta;		// sorted keys inserted after the build
+	int			nDelta;
+	int			deltaCapacity;
+} RMI;
+
+////////////////////////////////////////////////////////////////////////////////
+// Prototype declarations
+
+/* Builds an index of keys[0] ~ keys[n - 1] (ascending order; duplicates are kept once)
+	the keys are copied
+	return	index pointer
+			NULL if overflow or keys not sorted
+*/
+RMI* RMI_Create(const int* keys, int n);
+
+/* Deletes an index and recycles memory
+*/
+void RMI_Destroy(RMI* pIndex);
+
+/* Inserts key into the delta buffer (merged into the model when it fills up)
+	return	1 success
+			0 already in the index
+			-1 overflow
+*/
+int RMI_Insert(RMI* pIndex, int key);
+
+/* Retrieve index for the requested key
+	return	address of the key (valid until the next insertion)
+			NULL not found
+*/
+int* RMI_Retrieve(RMI* pIndex, int key);
+
+/* return number of keys in the index (delta buffer included)
+*/
+int RMI_Count(RMI* pIndex);
+
+/* return average error window of the models (positions searched per lookup)
+*/
+double RMI_AvgWindow(RMI* pIndex);
+
+/* return bytes allocated for the index (keys, models and delta buffer)
+*/
+size_t RMI_Bytes(RMI* pIndex);
@@ -0,0 +1,228 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, rand, atoi
+#include <time.h> // clock_gettime
+
+#include "adt_bst.h"
+#include "adt_bptree.h"
+#include "adt_frozen.h"
+
+#define DEFAULT_KEYS	20000
+#define PLAIN_LIMIT		50000	// plain mode takes O(n^2) on sorted streams; skipped above this
+
+#define SORTED			0
+#define REVERSE			1
+#define RANDOM			2
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* fills keys with 1 ~ n in stream order */
+static void make_stream(int* keys, int n, int stream)
+{
+	int i, j, tmp;
+
+	for (i = 0; i < n; i++)
+		keys[i] = (stream == REVERSE) ? n - i : i + 1;
+
+	if (stream != RANDOM) return;
+
+	for (i = n - 1; i > 0; i--)
+	{
+		j = rand() % (i + 1);
+		tmp = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+}
+
+/* runs the same insert/lookup/delete passes on the B+-tree and prints its row
+	return	0 success
+			3 lost keys
+			100 overflow
+*/
+static int bench_bptree(const int* keys, const int* probes, int n, const char* stream)
+{
+	BPTREE* tree = BPT_Create();
+	double t0, t1, t2, t3;
+	int height, i;
+	double bytes;
+	long found = 0;
+
+	if (!tree) return 100;
+
+	t0 = now_sec();
+	for (i = 0; i < n; i++)
+		if (!BPT_Insert(tree, keys[i])) return 100;
+	t1 = now_sec();
+
+	height = BPT_Height(tree);
+	bytes = (double)BPT_Bytes(tree) / n;
+
+	for (i = 0; i < n; i++)
+		found += BPT_Retrieve(tree, probes[i]) != NULL;
+	t2 = now_sec();
+
+	for (i = 0; i < n; i++)
+		BPT_Delete(tree, keys[i]);
+	t3 = now_sec();
+
+	if (found != n || !BPT_Empty(tree))
+	{
+		fprintf(stderr, "Error: %s/bptree lost keys\n", stream);
+		return 3;
+	}
+
+	printf("%-8s %-10s %9.2f %9.2f %9.2f %7d %9.1f\n", stream, "bptree",
+		n / (t1 - t0) / 1e6, n / (t2 - t1) / 1e6, n / (t3 - t2) / 1e6, height, bytes);
+
+	BPT_Destroy(tree);
+	return 0;
+}
+
+/* freezes a tree of the keys and runs the lookup pass on the frozen set
+	(a frozen set is read-only: insert and delete are not run; height is the
+	number of levels of the implicit tree)
+	return	0 success
+			3 lost keys
+			100 overflow
+*/
+static int bench_frozen(const int* keys, const int* probes, int n, const char* stream)
+{
+	TREE* tree = BST_Create();
+	FROZEN* frozen;
+	double t0, t1;
+	int height = 0, i;
+	double bytes;
+	long found = 0;
+
+	if (!tree || !BST_BuildFromArray(tree, keys, n)) return 100;
+	frozen = BST_Freeze(tree);
+	BST_Destroy(tree);
+	if (!frozen) return 100;
+
+	for (i = n; i > 0; i >>= 1)
+		height++;
+	bytes = (double)Frozen_Bytes(frozen) / n;
+
+	t0 = now_sec();
+	for (i = 0; i < n; i++)
+		found += Frozen_Retrieve(frozen, probes[i]) != NULL;
+	t1 = now_sec();
+
+	if (found != n)
+	{
+		fprintf(stderr, "Error: %s/frozen lost keys\n", stream);
+		return 3;
+	}
+
+	printf("%-8s %-10s %9s %9.2f %9s %7d %9.1f\n", stream, "frozen",
+		"-", n / (t1 - t0) / 1e6, "-", height, bytes);
+
+	Frozen_Destroy(frozen);
+	return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Inserts, looks up and deletes N distinct keys in sorted, reverse-sorted and
+// random order with every tree mode and the B+-tree, looks them up in a frozen
+// set, and reports throughput and height
+//	usage: bench_bst [N]
+int main(int argc, char** argv)
+{
+	static const char* streamName[] = { "sorted", "reverse", "random" };
+	static const char* modeName[] = { "plain", "treap", "scapegoat" };
+	int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_KEYS;
+	int* keys;
+	int* probes;
+	int stream, mode, i, ret;
+	long found;
+
+	if (n <= 0)
+	{
+		fprintf(stderr, "usage: %s [N]\n", argv[0]);
+		return 1;
+	}
+
+	keys = (int*)malloc(sizeof(int) * n);
+	probes = (int*)malloc(sizeof(int) * n);
+	if (!keys || !probes)
+	{
+		fprintf(stderr, "Error: out of memory\n");
+		return 100;
+	}
+
+	printf("%d keys (Mops/s)\n", n);
+	printf("%-8s %-10s %9s %9s %9s %7s %9s\n", "stream", "mode", "insert", "lookup", "delete", "height", "bytes/key");
+
+	for (stream = SORTED; stream <= RANDOM; stream++)
+	{
+		for (mode = BST_PLAIN; mode <= BST_SCAPEGOAT; mode++)
+		{
+			TREE* tree;
+			double t0, t1, t2, t3;
+			int height;
+			double bytes;
+
+			if (mode == BST_PLAIN && stream != RANDOM && n > PLAIN_LIMIT)
+			{
+				printf("%-8s %-10s %9s\n", streamName[stream], modeName[mode], "skipped");
+				continue;
+			}
+
+			srand(2022);
+			make_stream(keys, n, stream);
+			make_stream(probes, n, RANDOM);
+
+			tree = BST_CreateMode(mode);
+			if (!tree) return 100;
+
+			t0 = now_sec();
+			for (i = 0; i < n; i++)
+				if (!BST_Insert(tree, keys[i])) return 100;
+			t1 = now_sec();
+
+			height = BST_Height(tree);
+			bytes = (double)BST_Bytes(tree) / n;
+
+			found = 0;
+			for (i = 0; i < n; i++)
+				found += BST_Retrieve(tree, probes[i]) != NULL;
+			t2 = now_sec();
+
+			for (i = 0; i < n; i++)
+				BST_Delete(tree, keys[i]);
+			t3 = now_sec();
+
+			if (found != n || !BST_Empty(tree))
+			{
+				fprintf(stderr, "Error: %s/%s lost keys\n", streamName[stream], modeName[mode]);
+				return 3;
+			}
+
+			printf("%-8s %-10s %9.2f %9.2f %9.2f %7d %9.1f\n", streamName[stream], modeName[mode],
+				n / (t1 - t0) / 1e6, n / (t2 - t1) / 1e6, n / (t3 - t2) / 1e6, height, bytes);
+
+			BST_Destroy(tree);
+		}
+
+		// same keys and probes as the modes above
+		srand(2022);
+		make_stream(keys, n, stream);
+		make_stream(probes, n, RANDOM);
+
+		ret = bench_bptree(keys, probes, n, streamName[stream]);
+		if (ret) return ret;
+
+		ret = bench_frozen(keys, probes, n, streamName[stream]);
+		if (ret) return ret;
+	}
+
+	free(keys);
+	free(probes);
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, rand, atoi, qsort
+#include <time.h> // clock_gettime
+
+#include "adt_bst.h"
+#include "adt_frozen.h"
+#include "adt_rmi.h"
+
+#define DEFAULT_KEYS	1000000
+#define ZIPF_GAPS		1024	// zipf gaps are 1 ~ ZIPF_GAPS (gap g comes with weight 1 / g)
+
+#define UNIFORM			0
+#define ZIPF			1
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int cmp_int(const void* a, const void* b)
+{
+	int x = *(const int*)a;
+	int y = *(const int*)b;
+	return (x > y) - (x < y);
+}
+
+/* fills keys with n sorted distinct keys
+	uniform: random over 0 ~ RAND_MAX
+	zipf: running sum of gaps drawn from a zipf distribution (dense runs broken
+	by rare long jumps)
+	return	number of keys (duplicates of uniform keys are dropped)
+*/
+static int make_keys(int* keys, int n, int set)
+{
+	double cdf[ZIPF_GAPS];
+	double sum = 0.0, u;
+	int i, k, lo, hi, mid;
+
+	if (set == UNIFORM)
+	{
+		for (i = 0; i < n; i++)
+			keys[i] = rand();
+		qsort(keys, n, sizeof(int), cmp_int);
+
+		for (i = k = 0; i < n; i++)
+			if (k == 0 || keys[i] != keys[k - 1])
+				keys[k++] = keys[i];
+		return k;
+	}
+
+	for (i = 0; i < ZIPF_GAPS; i++)
+	{
+		sum += 1.0 / (i + 1);
+		cdf[i] = sum;
+	}
+
+	k = 0;
+	for (i = 0; i < n; i++)
+	{
+		u = (rand() + 0.5) / ((double)RAND_MAX + 1.0) * sum;
+		lo = 0;
+		hi = ZIPF_GAPS - 1;
+		while (lo < hi)
+		{
+			mid = lo + (hi - lo) / 2;
+			if (cdf[mid] < u) lo = mid + 1;
+			else hi = mid;
+		}
+		k += lo + 1;
+		keys[i] = k;
+	}
+	return n;
+}
+
+static void print_row(const char* set, const char* index, int n, double sec, size_t bytes, double window)
+{
+	printf("%-8s %-12s %9.2f %9.1f", set, index, n / sec / 1e6, (double)bytes / n);
+	if (window > 0) printf(" %9.1f", window);
+	printf("\n");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Looks up N keys of a uniform and a zipf key set in a balanced BST, its frozen
+// Eytzinger copy and a learned index (also with 1/64 more keys in its delta
+// buffer), and reports lookup throughput, memory and the model error window
+//	usage: bench_index [N]
+int main(int argc, char** argv)
+{
+	static const char* setName[] = { "uniform", "zipf" };
+	int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_KEYS;
+	int* keys;
+	int* probes;
+	int set, i, m;
+	long found;
+
+	if (n <= 0)
+	{
+		fprintf(stderr, "usage: %s [N]\n", argv[0]);
+		return 1;
+	}
+
+	keys = (int*)malloc(sizeof(int) * n);
+	probes = (int*)malloc(sizeof(int) * n);
+	if (!keys || !probes)
+	{
+		fprintf(stderr, "Error: out of memory\n");
+		return 100;
+	}
+
+	printf("%d lookups (Mops/s)\n", n);
+	printf("%-8s %-12s %9s %9s %9s\n", "keys", "index", "lookup", "bytes/key", "window");
+
+	for (set = UNIFORM; set <= ZIPF; set++)
+	{
+		TREE* tree;
+		FROZEN* frozen;
+		RMI* rmi;
+		double t0;
+
+		srand(2022);
+		m = make_keys(keys, n, set);
+
+		// every lookup hits a key
+		for (i = 0; i < n; i++)
+			probes[i] = keys[rand() % m];
+
+		tree = BST_Create();
+		if (!tree || !BST_BuildFromSorted(tree, keys, m)) return 100;
+		frozen = BST_Freeze(tree);
+		rmi = RMI_Create(keys, m);
+		if (!frozen || !rmi) return 100;
+
+		found = 0;
+		t0 = now_sec();
+		for (i = 0; i < n; i++)
+			found += BST_Retrieve(tree, probes[i]) != NULL;
+		print_row(setName[set], "bst", n, now_sec() - t0, BST_Bytes(tree), 0);
+
+		t0 = now_sec();
+		for (i = 0; i < n; i++)
+			found += Frozen_Retrieve(frozen, probes[i]) != NULL;
+		print_row(setName[set], "frozen", n, now_sec() - t0, Frozen_Bytes(frozen), 0);
+
+		t0 = now_sec();
+		for (i = 0; i < n; i++)
+			found += RMI_Retrieve(rmi, probes[i]) != NULL;
+		print_row(setName[set], "rmi", n, now_sec() - t0, RMI_Bytes(rmi), RMI_AvgWindow(rmi));
+
+		// keys between the built ones stay in the delta buffer (below n / RMI_DELTA_RATIO)
+		for (i = 0; i < m / 64; i++)
+			if (RMI_Insert(rmi, keys[rand() % m] + 1) < 0) return 100;
+
+		t0 = now_sec();
+		for (i = 0; i < n; i++)
+			found += RMI_Retrieve(rmi, probes[i]) != NULL;
+		print_row(setName[set], "rmi+delta", n, now_sec() - t0, RMI_Bytes(rmi), RMI_AvgWindow(rmi));
+
+		if (found != 4L * n)
+		{
+			fprintf(stderr, "Error: %s lost keys\n", setName[set]);
+			return 3;
+		}
+
+		BST_Destroy(tree);
+		Frozen_Destroy(frozen);
+		RMI_Destroy(rmi);
+	}
+
+	free(keys);
+	free(probes);
+
+	return 0;
+}
@@ -0,0 +1,205 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, rand_r, atoi
+#include <time.h> // clock_gettime
+#include <unistd.h> // sysconf
+#include <pthread.h>
+
+#include "adt_bst.h"
+#include "adt_lfbst.h"
+
+#define DEFAULT_KEYS	100000
+#define OPS_PER_KEY		4		// operations per run: OPS_PER_KEY * N, split among the threads
+
+typedef struct
+{
+	const char*	name;
+	int			insert;		// percent of operations (the rest are retrieves)
+	int			delete;
+} MIX;
+
+typedef struct
+{
+	LFBST*				lf;			// lock-free set, or
+	TREE*				tree;		// BST behind mutex
+	pthread_mutex_t*	mutex;
+	pthread_barrier_t*	start;
+	const MIX*			mix;
+	unsigned int		seed;
+	int					range;
+	int					ops;
+	long				inserted;
+	long				deleted;
+	long				found;
+} WORKER;
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void* worker(void* arg)
+{
+	WORKER* w = (WORKER*)arg;
+	LF_THREAD* handle = NULL;
+	int i, op, key;
+
+	if (w->lf) handle = LFBST_Attach(w->lf);
+	pthread_barrier_wait(w->start);
+
+	for (i = 0; i < w->ops; i++)
+	{
+		op = rand_r(&w->seed) % 100;
+		key = rand_r(&w->seed) % w->range;
+
+		if (handle)
+		{
+			if (op < w->mix->insert) w->inserted += LFBST_Insert(handle, key) == 1;
+			else if (op < w->mix->insert + w->mix->delete) w->deleted += LFBST_Delete(handle, key);
+			else w->found += LFBST_Retrieve(handle, key);
+			continue;
+		}
+
+		pthread_mutex_lock(w->mutex);
+		if (op < w->mix->insert)
+		{
+			if (BST_Retrieve(w->tree, key) == NULL) w->inserted += BST_Insert(w->tree, key);
+		}
+		else if (op < w->mix->insert + w->mix->delete) w->deleted += BST_Delete(w->tree, key);
+		else w->found += BST_Retrieve(w->tree, key) != NULL;
+		pthread_mutex_unlock(w->mutex);
+	}
+
+	if (handle) LFBST_Detach(handle);
+	return NULL;
+}
+
+/* runs OPS_PER_KEY * n operations of mix on threads workers over a set
+	prefilled with n keys of 0 ~ 2n - 1 (lock-free, or a treap behind a mutex)
+	return	Mops/s
+			-1 if the set lost or gained keys, -2 if overflow
+*/
+static double run(int n, int threads, const MIX* mix, int lockFree)
+{
+	pthread_t* tid = (pthread_t*)malloc(sizeof(pthread_t) * threads);
+	WORKER* w = (WORKER*)malloc(sizeof(WORKER) * threads);
+	pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+	pthread_barrier_t start;
+	LFBST* lf = NULL;
+	TREE* tree = NULL;
+	LF_THREAD* handle;
+	unsigned int seed = 2022;
+	long expect = 0;
+	double t0, t1;
+	int i, count;
+
+	if (!tid || !w) return -2;
+
+	if (lockFree)
+	{
+		lf = LFBST_Create(threads + 1);
+		if (!lf || !(handle = LFBST_Attach(lf))) return -2;
+		while (expect < n)
+		{
+			i = LFBST_Insert(handle, rand_r(&seed) % (2 * n));
+			if (i < 0) return -2;
+			expect += i;
+		}
+		LFBST_Detach(handle);
+	}
+	else
+	{
+		tree = BST_CreateMode(BST_TREAP);
+		if (!tree) return -2;
+		while (expect < n)
+		{
+			i = rand_r(&seed) % (2 * n);
+			if (BST_Retrieve(tree, i) != NULL) continue;
+			if (!BST_Insert(tree, i)) return -2;
+			expect++;
+		}
+	}
+
+	pthread_barrier_init(&start, NULL, threads + 1);
+	for (i = 0; i < threads; i++)
+	{
+		w[i].lf = lf;
+		w[i].tree = tree;
+		w[i].mutex = &mutex;
+		w[i].start = &start;
+		w[i].mix = mix;
+		w[i].seed = 2022 + i;
+		w[i].range = 2 * n;
+		w[i].ops = OPS_PER_KEY * n / threads;
+		w[i].inserted = w[i].deleted = w[i].found = 0;
+		if (pthread_create(&tid[i], NULL, worker, &w[i]) != 0) return -2;
+	}
+
+	pthread_barrier_wait(&start);
+	t0 = now_sec();
+	for (i = 0; i < threads; i++)
+	{
+		pthread_join(tid[i], NULL);
+		expect += w[i].inserted - w[i].deleted;
+	}
+	t1 = now_sec();
+
+	count = lockFree ? LFBST_Count(lf) : BST_Count(tree);
+
+	pthread_barrier_destroy(&start);
+	if (lf) LFBST_Destroy(lf);
+	if (tree) BST_Destroy(tree);
+	free(tid);
+	free(w);
+
+	if (count != expect) return -1;
+	return (double)(OPS_PER_KEY * n / threads) * threads / (t1 - t0) / 1e6;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Runs a read-heavy and a write-heavy mix on the lock-free set and on a treap
+// behind one mutex with 1, 2, 4, ... threads up to the number of cores, and
+// reports throughput (Mops/s) of each
+//	usage: bench_lfbst [N [MAX_THREADS]]
+int main(int argc, char** argv)
+{
+	static const MIX mixes[] = { { "read", 5, 5 }, { "write", 40, 40 } };
+	int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_KEYS;
+	int maxThreads = (argc > 2) ? atoi(argv[2]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+	double lf, locked;
+	int m, threads;
+
+	if (n <= 0 || maxThreads < 1 || maxThreads >= LF_MAX_THREADS)
+	{
+		fprintf(stderr, "usage: %s [N [MAX_THREADS (1 ~ %d)]]\n", argv[0], LF_MAX_THREADS - 1);
+		return 1;
+	}
+
+	printf("%d keys of 0 ~ %d, %d operations per run (Mops/s)\n", n, 2 * n - 1, OPS_PER_KEY * n);
+	printf("%-6s %-8s %9s %9s\n", "mix", "threads", "lfbst", "bst+lock");
+
+	for (m = 0; m < 2; m++)
+		for (threads = 1; ; threads *= 2)
+		{
+			if (threads > maxThreads) threads = maxThreads;
+
+			lf = run(n, threads, &mixes[m], 1);
+			locked = run(n, threads, &mixes[m], 0);
+
+			if (lf == -2 || locked == -2)
+			{
+				fprintf(stderr, "Error: out of memory\n");
+				return 100;
+			}
+			if (lf < 0 || locked < 0)
+			{
+				fprintf(stderr, "Error: %s/%d threads lost keys\n", mixes[m].name, threads);
+				return 3;
+			}
+			printf("%-6s %-8d %9.2f %9.2f\n", mixes[m].name, threads, lf, locked);
+			if (threads == maxThreads) break;
+		}
+
+	return 0;
+}
@@ -0,0 +1,207 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, rand, atoi
+#include <time.h> // clock_gettime
+#include <limits.h> // INT_MIN
+#include <pthread.h>
+
+#include "adt_bst.h"
+#include "adt_frozen.h"
+#include "adt_pbst.h"
+
+#define DEFAULT_KEYS	100000
+#define DEFAULT_READERS	2
+#define MAX_READERS		64
+#define LOOKUPS_PER_PIN	64
+#define VISIT_EVERY		256		// a reader walks a whole pinned version every this many pins
+
+typedef struct
+{
+	PBST*			tree;
+	atomic_int*	done;
+	unsigned int	seed;
+	long			pins;
+	long			lookups;
+	long			found;
+	long			visits;
+	long			broken;		// visits that saw a version change under them
+} READER;
+
+typedef struct
+{
+	int		last;
+	int		n;
+	int		sorted;
+} VISIT;
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void check_data(int data, void* arg)
+{
+	VISIT* v = (VISIT*)arg;
+
+	if (data <= v->last) v->sorted = 0;
+	v->last = data;
+	v->n++;
+}
+
+/* pins versions while the writer runs: lookups on each, and now and then a
+	full walk that must match the pinned count and order */
+static void* reader(void* arg)
+{
+	READER* r = (READER*)arg;
+	const PVERSION* version;
+	VISIT v;
+	int i;
+
+	while (!atomic_load(r->done))
+	{
+		version = PBST_Pin(r->tree);
+
+		for (i = 0; i < LOOKUPS_PER_PIN; i++)
+			r->found += PVersion_Member(version, rand_r(&r->seed));
+		r->lookups += LOOKUPS_PER_PIN;
+
+		if (r->pins % VISIT_EVERY == 0)
+		{
+			v.last = INT_MIN;
+			v.n = 0;
+			v.sorted = 1;
+			PVersion_Visit(version, check_data, &v);
+			if (!v.sorted || v.n != PVersion_Count(version)) r->broken++;
+			r->visits++;
+		}
+
+		PBST_Unpin(version);
+		r->pins++;
+	}
+	return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// One writer replaces N keys (a delete and an insert each) of an N-key
+// persistent set while READERS threads pin versions and look keys up in them;
+// then the cost of one snapshot is set against freezing a copy of a BST
+//	usage: bench_pbst [N [READERS]]
+int main(int argc, char** argv)
+{
+	int n = (argc > 1) ? atoi(argv[1]) : DEFAULT_KEYS;
+	int readers = (argc > 2) ? atoi(argv[2]) : DEFAULT_READERS;
+	pthread_t threads[MAX_READERS];
+	READER r[MAX_READERS];
+	atomic_int done = 0;
+	PBST* ptree;
+	TREE* tree;
+	FROZEN* frozen;
+	const PVERSION* version;
+	int* keys;
+	long pins = 0, lookups = 0, visits = 0, broken = 0;
+	double t0, t1;
+	int i, j, key, ret;
+
+	if (n <= 0 || readers < 0 || readers > MAX_READERS)
+	{
+		fprintf(stderr, "usage: %s [N [READERS (0 ~ %d)]]\n", argv[0], MAX_READERS);
+		return 1;
+	}
+
+	keys = (int*)malloc(sizeof(int) * n);
+	ptree = PBST_Create();
+	tree = BST_CreateMode(BST_TREAP);
+	if (!keys || !ptree || !tree)
+	{
+		fprintf(stderr, "Error: out of memory\n");
+		return 100;
+	}
+
+	srand(2022);
+
+	t0 = now_sec();
+	for (i = 0; i < n; )
+	{
+		keys[i] = rand();
+		ret = PBST_Insert(ptree, keys[i]);
+		if (ret < 0) return 100;
+		i += ret;
+	}
+	t1 = now_sec();
+	printf("%d keys, %d readers\n", n, readers);
+	printf("build    %9.2f Mops/s\n", n / (t1 - t0) / 1e6);
+
+	for (i = 0; i < readers; i++)
+	{
+		r[i].tree = ptree;
+		r[i].done = &done;
+		r[i].seed = 2022 + i;
+		r[i].pins = r[i].lookups = r[i].found = r[i].visits = r[i].broken = 0;
+		if (pthread_create(&threads[i], NULL, reader, &r[i]) != 0)
+		{
+			fprintf(stderr, "Error: cannot start reader\n");
+			return 100;
+		}
+	}
+
+	// each update replaces a random key with a new one
+	t0 = now_sec();
+	for (i = 0; i < n; i++)
+	{
+		j = rand() % n;
+		do
+			key = rand();
+		while (PBST_Member(ptree, key));
+
+		if (PBST_Delete(ptree, keys[j]) != 1 || PBST_Insert(ptree, key) != 1) return 100;
+		keys[j] = key;
+	}
+	t1 = now_sec();
+	atomic_store(&done, 1);
+
+	for (i = 0; i < readers; i++)
+	{
+		pthread_join(threads[i], NULL);
+		pins += r[i].pins;
+		lookups += r[i].lookups;
+		visits += r[i].visits;
+		broken += r[i].broken;
+	}
+
+	printf("update   %9.2f Mops/s (2 versions each)\n", 2.0 * n / (t1 - t0) / 1e6);
+	if (readers > 0)
+		printf("read     %9.2f Mops/s, %ld pins, %ld full walks\n", lookups / (t1 - t0) / 1e6, pins, visits);
+
+	if (broken != 0 || PBST_Count(ptree) != n)
+	{
+		fprintf(stderr, "Error: %ld pinned versions changed\n", broken);
+		return 3;
+	}
+
+	// snapshot cost: pinning a version against copying the tree
+	for (i = 0; i < n; i++)
+		if (!BST_Insert(tree, keys[i])) return 100;
+
+	t0 = now_sec();
+	for (i = 0; i < n; i++)
+	{
+		version = PBST_Pin(ptree);
+		PBST_Unpin(version);
+	}
+	t1 = now_sec();
+	printf("snapshot %9.1f ns (pin)\n", (t1 - t0) / n * 1e9);
+
+	t0 = now_sec();
+	frozen = BST_Freeze(tree);
+	t1 = now_sec();
+	if (!frozen) return 100;
+	printf("snapshot %9.1f ns (BST_Freeze copy)\n", (t1 - t0) * 1e9);
+
+	Frozen_Destroy(frozen);
+	BST_Destroy(tree);
+	PBST_Destroy(ptree);
+	free(keys);
+
+	return 0;
+}
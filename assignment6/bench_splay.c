@@ -0,0 +1,335 @@
+#include <stdio.h>
+#include <stdlib.h> // malloc, rand_r, atoi
+#include <string.h> // strcmp
+#include <time.h> // clock_gettime
+
+#include "adt_bst.h"
+
+#define DEFAULT_KEYS	100000
+#define OPS_PER_KEY		4		// synthetic trace length: OPS_PER_KEY * N
+#define INSERT_PCT		5		// synthetic traces: 5% inserts, 5% deletes, the rest retrieves
+#define DELETE_PCT		5
+#define SESSION_KEYS	256		// session trace: keys a session keeps coming back to
+#define SESSION_PCT		90		// percent of session accesses to those keys
+
+#define OP_INSERT		'i'
+#define OP_DELETE		'd'
+#define OP_RETRIEVE		'r'
+
+#define UNIFORM			0
+#define ZIPF			1
+#define SESSION			2
+#define SEQUENTIAL		3
+
+typedef struct
+{
+	char	op;
+	int		key;
+} STEP;
+
+static double now_sec(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* fills trace with m operations on keys 0 ~ n - 1
+	uniform: every key alike
+	zipf: key of rank r comes with weight 1 / r (ranks scattered over the keys)
+	session: SESSION_PCT of accesses go back to the last SESSION_KEYS new keys
+	sequential: 0, 1, 2, ... over and over
+	return	1 success
+			0 overflow
+*/
+static int make_trace(STEP* trace, int m, int n, int kind)
+{
+	unsigned int seed = 2022;
+	int recent[SESSION_KEYS];
+	double* cdf = NULL;
+	int* perm = NULL;
+	double sum = 0.0, u;
+	int i, j, k, lo, hi, mid, op;
+
+	if (kind == ZIPF)
+	{
+		cdf = (double*)malloc(sizeof(double) * n);
+		perm = (int*)malloc(sizeof(int) * n);
+		if (!cdf || !perm)
+		{
+			free(cdf);
+			free(perm);
+			return 0;
+		}
+		for (i = 0; i < n; i++)
+		{
+			sum += 1.0 / (i + 1);
+			cdf[i] = sum;
+			perm[i] = i;
+		}
+		for (i = n - 1; i > 0; i--)
+		{
+			j = rand_r(&seed) % (i + 1);
+			k = perm[i];
+			perm[i] = perm[j];
+			perm[j] = k;
+		}
+	}
+	for (i = 0; i < SESSION_KEYS; i++)
+		recent[i] = rand_r(&seed) % n;
+
+	for (i = 0; i < m; i++)
+	{
+		op = rand_r(&seed) % 100;
+		trace[i].op = (op < INSERT_PCT) ? OP_INSERT : (op < INSERT_PCT + DELETE_PCT) ? OP_DELETE : OP_RETRIEVE;
+
+		if (kind == UNIFORM) k = rand_r(&seed) % n;
+		else if (kind == ZIPF)
+		{
+			// first rank whose cumulative weight reaches u
+			u = (rand_r(&seed) + 0.5) / ((double)RAND_MAX + 1.0) * sum;
+			lo = 0;
+			hi = n - 1;
+			while (lo < hi)
+			{
+				mid = lo + (hi - lo) / 2;
+				if (cdf[mid] < u) lo = mid + 1;
+				else hi = mid;
+			}
+			k = perm[lo];
+		}
+		else if (kind == SESSION)
+		{
+			if (rand_r(&seed) % 100 < SESSION_PCT) k = recent[rand_r(&seed) % SESSION_KEYS];
+			else k = recent[i % SESSION_KEYS] = rand_r(&seed) % n;
+		}
+		else k = i % n;
+		trace[i].key = k;
+	}
+
+	free(cdf);
+	free(perm);
+	return 1;
+}
+
+/* reads a trace of lines "i KEY", "d KEY" or "r KEY" from path
+	return	trace (caller frees it); m is the number of operations
+			NULL if the file cannot be read or overflow
+*/
+static STEP* read_trace(const char* path, int* m)
+{
+	FILE* fp = fopen(path, "r");
+	int capacity = 1024;
+	STEP* trace;
+	STEP* tmp;
+	char op;
+	int key;
+
+	if (!fp) return NULL;
+	trace = (STEP*)malloc(sizeof(STEP) * capacity);
+	*m = 0;
+	while (trace && fscanf(fp, " %c %d", &op, &key) == 2)
+	{
+		if (op != OP_INSERT && op != OP_DELETE && op != OP_RETRIEVE) continue;
+		if (*m == capacity)
+		{
+			capacity *= 2;
+			tmp = (STEP*)realloc(trace, sizeof(STEP) * capacity);
+			if (!tmp)
+			{
+				free(trace);
+				trace = NULL;
+				break;
+			}
+			trace = tmp;
+		}
+		trace[*m].op = op;
+		trace[(*m)++].key = key;
+	}
+	fclose(fp);
+	return trace;
+}
+
+/* applies one step (an insert of a key already in the tree is dropped)
+	return	1 the key was found, inserted or deleted
+			0 otherwise, -1 overflow
+*/
+static int apply(TREE* tree, const STEP* step)
+{
+	if (step->op == OP_RETRIEVE) return BST_Retrieve(tree, step->key) != NULL;
+	if (step->op == OP_DELETE) return BST_Delete(tree, step->key);
+	if (BST_Retrieve(tree, step->key) != NULL) return 0;
+	return BST_Insert(tree, step->key) ? 1 : -1;
+}
+
+/* makes a tree of mode holding keys 0 ~ n - 1 (inserted in random order)
+	return	tree
+			NULL if overflow
+*/
+static TREE* prefill(int mode, int n)
+{
+	TREE* tree = BST_CreateMode(mode);
+	unsigned int seed = 7;
+	int* keys = (int*)malloc(sizeof(int) * (n > 0 ? n : 1));
+	int i, j, k;
+
+	if (!tree || !keys)
+	{
+		if (tree) BST_Destroy(tree);
+		free(keys);
+		return NULL;
+	}
+	for (i = 0; i < n; i++)
+		keys[i] = i;
+	for (i = n - 1; i > 0; i--)
+	{
+		j = rand_r(&seed) % (i + 1);
+		k = keys[i];
+		keys[i] = keys[j];
+		keys[j] = k;
+	}
+	for (i = 0; i < n; i++)
+		if (!BST_Insert(tree, keys[i]))
+		{
+			BST_Destroy(tree);
+			tree = NULL;
+			break;
+		}
+	free(keys);
+	return tree;
+}
+
+/* replays trace on a tree of mode prefilled with keys 0 ~ n - 1, once timed and
+	once measuring the depth of every key found in the tree before its access
+	return	Mops/s; depth is the average access depth, hits the steps that hit
+			-1 overflow
+*/
+static double replay(const STEP* trace, int m, int n, int mode, double* depth, long* hits)
+{
+	TREE* tree;
+	double t0, t1;
+	long long sum = 0;
+	long accesses = 0;
+	int i, d, r;
+
+	tree = prefill(mode, n);
+	if (!tree) return -1;
+	*hits = 0;
+	t0 = now_sec();
+	for (i = 0; i < m; i++)
+	{
+		r = apply(tree, &trace[i]);
+		if (r < 0)
+		{
+			BST_Destroy(tree);
+			return -1;
+		}
+		*hits += r;
+	}
+	t1 = now_sec();
+	BST_Destroy(tree);
+
+	// BST_Depth does not splay, so this pass sees the same trees as the timed one
+	tree = prefill(mode, n);
+	if (!tree) return -1;
+	for (i = 0; i < m; i++)
+	{
+		d = BST_Depth(tree, trace[i].key);
+		if (d >= 0)
+		{
+			sum += d;
+			accesses++;
+		}
+		if (apply(tree, &trace[i]) < 0)
+		{
+			BST_Destroy(tree);
+			return -1;
+		}
+	}
+	BST_Destroy(tree);
+
+	*depth = accesses ? (double)sum / accesses : 0.0;
+	return m / (t1 - t0) / 1e6;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replays access traces on the treap, the scapegoat tree and the splay tree and
+// reports the average depth of the keys accessed and throughput (Mops/s); the
+// synthetic traces run OPS_PER_KEY * N operations on keys 0 ~ N - 1 (prefilled)
+// and a trace file (lines "i KEY", "d KEY" or "r KEY") runs on an empty tree
+//	usage: bench_splay [N] or bench_splay -t TRACE
+int main(int argc, char** argv)
+{
+	static const char* traceName[] = { "uniform", "zipf", "session", "sequential" };
+	static const char* modeName[] = { "treap", "scapegoat", "splay" };
+	static const int modes[] = { BST_TREAP, BST_SCAPEGOAT, BST_SPLAY };
+	int n = DEFAULT_KEYS, m, kind, first, last, i;
+	STEP* trace = NULL;
+	double rate[3], depth[3];
+	long hits[3];
+
+	if (argc == 3 && strcmp(argv[1], "-t") == 0)
+	{
+		trace = read_trace(argv[2], &m);
+		if (!trace)
+		{
+			fprintf(stderr, "Error: cannot read %s\n", argv[2]);
+			return 2;
+		}
+		n = 0;
+		first = last = -1;
+	}
+	else
+	{
+		if (argc > 2 || (argc == 2 && (n = atoi(argv[1])) <= 0))
+		{
+			fprintf(stderr, "usage: %s [N] or %s -t TRACE\n", argv[0], argv[0]);
+			return 1;
+		}
+		m = OPS_PER_KEY * n;
+		trace = (STEP*)malloc(sizeof(STEP) * m);
+		first = UNIFORM;
+		last = SEQUENTIAL;
+	}
+	if (!trace)
+	{
+		fprintf(stderr, "Error: out of memory\n");
+		return 100;
+	}
+
+	printf("%d keys, %d operations per trace (average access depth / Mops/s)\n", n, m);
+	printf("%-11s", "trace");
+	for (i = 0; i < 3; i++)
+		printf(" %19s", modeName[i]);
+	printf("\n");
+
+	for (kind = first; kind <= last; kind++)
+	{
+		if (kind >= 0 && !make_trace(trace, m, n, kind))
+		{
+			fprintf(stderr, "Error: out of memory\n");
+			return 100;
+		}
+		for (i = 0; i < 3; i++)
+		{
+			rate[i] = replay(trace, m, n, modes[i], &depth[i], &hits[i]);
+			if (rate[i] < 0)
+			{
+				fprintf(stderr, "Error: out of memory\n");
+				return 100;
+			}
+			if (hits[i] != hits[0])
+			{
+				fprintf(stderr, "Error: %s disagrees with %s\n", modeName[i], modeName[0]);
+				return 3;
+			}
+		}
+		printf("%-11s", (kind >= 0) ? traceName[kind] : "file");
+		for (i = 0; i < 3; i++)
+			printf(" %9.2f %9.2f", depth[i], rate[i]);
+		printf("\n");
+	}
+
+	free(trace);
+	return 0;
+}
@@ -1,113 +1,348 @@
-#include <stdlib.h> // malloc, atoi, rand
+#include <stdlib.h> // atoi, rand, malloc, realloc
 #include <stdio.h>
+#include <math.h> // pow
+#include <string.h> // strcmp
 #include <assert.h>
-#include <time.h> // time
+#include <time.h> // time, clock_gettime
+
+#include "adt_bst.h"
+#include "adt_intset.h"
 
 #define RANDOM_INPUT	1
 #define FILE_INPUT		2
 
-////////////////////////////////////////////////////////////////////////////////
-// TREE type definition
-typedef struct node
-{
-	int			data;
-	struct node* left;
-	struct node* right;
-} NODE;
+// bench key distributions
+#define UNIFORM_KEYS	0
+#define SORTED_KEYS		1
+#define ZIPF_KEYS		2
 
-typedef struct
-{
-	NODE* root;
-} TREE;
+#define ZIPF_S			1.0		// zipf exponent (key of rank r comes with weight 1 / r^s)
+#define BENCH_SEED		2022
 
-////////////////////////////////////////////////////////////////////////////////
-// Prototype declarations
+// bench backends besides the tree modes
+#define INTSET_MODE		0x100	// bitset over the key range (a set: duplicates are not kept)
+#define AUTO_MODE		0x200	// INTSET_MODE if the key range is dense (IntSet_Dense), else BST_TREAP
+
+// bench operations
+#define OP_INSERT		0
+#define OP_DELETE		1
+#define OP_RETRIEVE		2
 
-/* Allocates dynamic memory for a tree head node and returns its address to caller
-	return	head node pointer
+/* return	tree mode for name (plain, treap, scapegoat, splay; intset, auto for bench)
+			-1 if unknown
+*/
+static int _modeOf(const char* name) {
+	if (strcmp(name, "plain") == 0) return BST_PLAIN;
+	if (strcmp(name, "treap") == 0) return BST_TREAP;
+	if (strcmp(name, "scapegoat") == 0) return BST_SCAPEGOAT;
+	if (strcmp(name, "splay") == 0) return BST_SPLAY;
+	if (strcmp(name, "intset") == 0) return INTSET_MODE;
+	if (strcmp(name, "auto") == 0) return AUTO_MODE;
+	return -1;
+}
+
+/* reads all integers in fp
+	return	array of integers (caller frees it); n is the number of integers
 			NULL if overflow
 */
-TREE* BST_Create(void);
+static int* _readKeys(FILE* fp, int* n) {
+	int capacity = 1024;
+	int* keys = (int*)malloc(sizeof(int) * capacity);
+	int* tmp;
+	int data;
 
-/* Deletes all data in tree and recycles memory
- */
-void BST_Destroy(TREE* pTree);
+	*n = 0;
+	if (keys == NULL) return NULL;
+
+	while (fscanf(fp, "%d", &data) == 1) {
+		if (*n == capacity) {
+			capacity *= 2;
+			tmp = (int*)realloc(keys, sizeof(int) * capacity);
+			if (tmp == NULL) {
+				free(keys);
+				return NULL;
+			}
+			keys = tmp;
+		}
+		keys[(*n)++] = data;
+	}
+	return keys;
+}
 
-/* internal function (not mandatory)
- */
-static void _destroy(NODE* root);
+/* return	key distribution for name (uniform, sorted, zipf)
+			-1 if unknown
+*/
+static int _distOf(const char* name) {
+	if (strcmp(name, "uniform") == 0) return UNIFORM_KEYS;
+	if (strcmp(name, "sorted") == 0) return SORTED_KEYS;
+	if (strcmp(name, "zipf") == 0) return ZIPF_KEYS;
+	return -1;
+}
 
-/* Inserts new data into the tree
-	return	1 success
-			0 overflow
+/* return	monotonic time in nanoseconds
 */
-int BST_Insert(TREE* pTree, int data);
+static long long _nsec(void) {
+	struct timespec ts;
 
-/* internal function (not mandatory)
- */
-static void _insert(NODE* root, NODE* newPtr);
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
 
-NODE* _makeNode(int data);
+/* compare function for qsort
+*/
+static int _cmpLatency(const void* a, const void* b) {
+	long long x = *(const long long*)a;
+	long long y = *(const long long*)b;
+
+	return (x > y) - (x < y);
+}
 
-/* Deletes a node with dltKey from the tree
+/* fills keys with the keys of n operations ops[] in a distribution
+	uniform: 1 ~ n * 3 (as the random input)
+	sorted: inserts take 1, 2, 3, ...; the other operations a key inserted before
+	zipf: 1 ~ n where key r comes with weight 1 / r^ZIPF_S
 	return	1 success
-			0 not found
+			0 overflow
 */
-int BST_Delete(TREE* pTree, int dltKey);
+static int _makeKeys(int* keys, const char* ops, int n, int dist) {
+	double* cdf;
+	double sum = 0.0, u;
+	int i, lo, hi, mid;
+
+	if (dist == UNIFORM_KEYS) {
+		for (i = 0; i < n; i++)
+			keys[i] = rand() % (n * 3) + 1;
+		return 1;
+	}
+	if (dist == SORTED_KEYS) {
+		int inserted = 0;
 
-/* internal function
-	success is 1 if deleted; 0 if not
-	return	pointer to root
-*/
-static NODE* _delete(NODE* root, int dltKey, int* success);
+		for (i = 0; i < n; i++) {
+			if (ops[i] == OP_INSERT) keys[i] = ++inserted;
+			else keys[i] = (inserted > 0) ? rand() % inserted + 1 : 1;
+		}
+		return 1;
+	}
 
-/* Retrieve tree for the node containing the requested key
-	return	address of data of the node containing the key
-			NULL not found
-*/
-int* BST_Retrieve(TREE* pTree, int key);
+	cdf = (double*)malloc(sizeof(double) * n);
+	if (!cdf) return 0;
 
-/* internal function
-	Retrieve node containing the requested key
-	return	address of the node containing the key
-			NULL not found
+	for (i = 0; i < n; i++) {
+		sum += 1.0 / pow(i + 1, ZIPF_S);
+		cdf[i] = sum;
+	}
+
+	// first rank whose cumulative weight reaches u
+	for (i = 0; i < n; i++) {
+		u = (rand() + 0.5) / ((double)RAND_MAX + 1.0) * sum;
+		lo = 0;
+		hi = n - 1;
+		while (lo < hi) {
+			mid = lo + (hi - lo) / 2;
+			if (cdf[mid] < u) lo = mid + 1;
+			else hi = mid;
+		}
+		keys[i] = lo + 1;
+	}
+
+	free(cdf);
+	return 1;
+}
+
+/* return	largest key _makeKeys makes for n operations in a distribution
 */
-static NODE* _retrieve(NODE* root, int key);
-
-/* prints tree using inorder traversal
- */
-void BST_Traverse(TREE* pTree);
-static void _traverse(NODE* root);
-
-/* Print tree using inorder right-to-left traversal
- */
-void printTree(TREE* pTree);
-/* internal traversal function
- */
-static void _inorder_print(NODE* root, int level);
-
-/*
-	return 1 if the tree is empty; 0 if not
+static int _maxKey(int n, int dist) {
+	return (dist == UNIFORM_KEYS) ? n * 3 : n;
+}
+
+/* runs n operations (insert, delete and retrieve mixed by weights mix[]) on tree
+	(or on set if it is not NULL) and reports throughput and p50/p99 latency per
+	operation, without printing the tree
+	return	0 success
+			100 overflow
 */
-int BST_Empty(TREE* pTree);
+static int _bench(TREE* tree, INTSET* set, int n, int dist, const int mix[3]) {
+	static const char* opName[] = { "insert", "delete", "retrieve" };
+	static const char* distName[] = { "uniform", "sorted", "zipf" };
+	int* keys = (int*)malloc(sizeof(int) * n);
+	char* ops = (char*)malloc(n);
+	long long* latency[3];
+	long long total[3] = { 0, 0, 0 };
+	int count[3] = { 0, 0, 0 };
+	int hits[3] = { 0, 0, 0 };
+	int weight = mix[0] + mix[1] + mix[2];
+	long long t0, t1, start;
+	int i, op, r, ret = 0;
+
+	for (op = 0; op < 3; op++)
+		latency[op] = (long long*)malloc(sizeof(long long) * n);
+
+	if (!keys || !ops || !latency[0] || !latency[1] || !latency[2]) {
+		printf("Cannot allocate bench data!\n");
+		ret = 100;
+		goto done;
+	}
+
+	for (i = 0; i < n; i++) {
+		r = rand() % weight;
+		ops[i] = (r < mix[0]) ? OP_INSERT : (r < mix[0] + mix[1]) ? OP_DELETE : OP_RETRIEVE;
+	}
+
+	if (!_makeKeys(keys, ops, n, dist)) {
+		printf("Cannot allocate bench data!\n");
+		ret = 100;
+		goto done;
+	}
+
+	start = _nsec();
+	for (i = 0; i < n; i++) {
+		op = ops[i];
+
+		t0 = _nsec();
+		if (set) {
+			// a key already in the set is not an overflow
+			if (op == OP_INSERT) r = IntSet_Insert(set, keys[i]) >= 0;
+			else if (op == OP_DELETE) r = IntSet_Delete(set, keys[i]);
+			else r = IntSet_Member(set, keys[i]);
+		}
+		else {
+			if (op == OP_INSERT) r = BST_Insert(tree, keys[i]);
+			else if (op == OP_DELETE) r = BST_Delete(tree, keys[i]);
+			else r = BST_Retrieve(tree, keys[i]) != NULL;
+		}
+		t1 = _nsec();
+
+		if (op == OP_INSERT && !r) {
+			printf("Cannot insert!\n");
+			ret = 100;
+			goto done;
+		}
+		hits[op] += r;
+		latency[op][count[op]++] = t1 - t0;
+		total[op] += t1 - t0;
+	}
+	t1 = _nsec();
+
+	printf("%d ops, %s keys, mix %d:%d:%d (insert:delete:retrieve)\n", n, distName[dist], mix[0], mix[1], mix[2]);
+	printf("%-9s %9s %9s %10s %9s %9s\n", "op", "count", "hits", "Mops/s", "p50(ns)", "p99(ns)");
+	for (op = 0; op < 3; op++) {
+		if (count[op] == 0) continue;
 
+		qsort(latency[op], count[op], sizeof(long long), _cmpLatency);
+		printf("%-9s %9d %9d %10.2f %9lld %9lld\n", opName[op], count[op], hits[op],
+			total[op] > 0 ? count[op] * 1e3 / total[op] : 0.0,
+			latency[op][count[op] / 2], latency[op][(int)(count[op] * 0.99)]);
+	}
+	if (set)
+		printf("total: %.2f Mops/s, keys %d, bytes %zu\n",
+			n * 1e3 / (t1 - start > 0 ? t1 - start : 1), IntSet_Count(set), IntSet_Bytes(set));
+	else
+		printf("total: %.2f Mops/s, height %d, nodes %d, data %d, bytes %zu\n",
+			n * 1e3 / (t1 - start > 0 ? t1 - start : 1), BST_Height(tree), BST_Nodes(tree), BST_Count(tree),
+			BST_Bytes(tree));
+
+done:
+	free(keys);
+	free(ops);
+	for (op = 0; op < 3; op++)
+		free(latency[op]);
+	return ret;
+}
+
+/* parses a mix "INSERT:DELETE:RETRIEVE" of non-negative weights
+	return	1 success
+			0 bad mix
+*/
+static int _mixOf(const char* str, int mix[3]) {
+	if (sscanf(str, "%d:%d:%d", &mix[0], &mix[1], &mix[2]) != 3) return 0;
+	if (mix[0] < 0 || mix[1] < 0 || mix[2] < 0) return 0;
+	return mix[0] + mix[1] + mix[2] > 0;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 int main(int argc, char** argv)
 {
 	int mode; // input mode
+	int treeMode = BST_PLAIN;
 	TREE* tree;
 	int data;
-
-	if (argc != 2)
+	int multiset = 0;
+	int bench = 0;
+	int benchKeys = 100000;
+	int dist = UNIFORM_KEYS;
+	int mix[3] = { 60, 20, 20 };
+	int ok = 1;
+	int arg = 1;
+
+	// options: -m MODE, -c (duplicates share a counted node),
+	// --bench [-n KEYS] [-d DIST] [-x MIX] (no FILE or number)
+	while (arg < argc && argv[arg][0] == '-' && ok)
+	{
+		if (strcmp(argv[arg], "-c") == 0)
+		{
+			multiset = BST_MULTISET;
+			arg++;
+		}
+		else if (strcmp(argv[arg], "--bench") == 0)
+		{
+			bench = 1;
+			arg++;
+		}
+		else if (arg + 1 >= argc) ok = 0;
+		else
+		{
+			if (strcmp(argv[arg], "-m") == 0) ok = (treeMode = _modeOf(argv[arg + 1])) >= 0;
+			else if (strcmp(argv[arg], "-n") == 0) ok = (benchKeys = atoi(argv[arg + 1])) > 0;
+			else if (strcmp(argv[arg], "-d") == 0) ok = (dist = _distOf(argv[arg + 1])) >= 0;
+			else if (strcmp(argv[arg], "-x") == 0) ok = _mixOf(argv[arg + 1], mix);
+			else ok = 0;
+			arg += 2;
+		}
+	}
+	// intset and auto only for bench: there is no tree to print
+	if (!ok || argc != arg + !bench || (!bench && treeMode > BST_SPLAY))
 	{
-		fprintf(stderr, "usage: %s FILE or %s number\n", argv[0], argv[0]);
+		fprintf(stderr, "usage: %s [-m plain|treap|scapegoat|splay] [-c] FILE or %s [-m plain|treap|scapegoat|splay] [-c] number\n", argv[0], argv[0]);
+		fprintf(stderr, "       %s [-m plain|treap|scapegoat|splay|intset|auto] [-c] --bench [-n KEYS] [-d uniform|sorted|zipf] [-x INSERT:DELETE:RETRIEVE]\n", argv[0]);
 		return 1;
 	}
 
+	if (bench)
+	{
+		INTSET* set = NULL;
+		int ret;
+
+		// keys of the bench are 1 ~ _maxKey: a bitset if that range is dense
+		if (treeMode == AUTO_MODE)
+		{
+			treeMode = IntSet_Dense(1, _maxKey(benchKeys, dist), benchKeys) ? INTSET_MODE : BST_TREAP;
+			printf("auto: %s\n", (treeMode == INTSET_MODE) ? "intset" : "treap");
+		}
+
+		if (treeMode == INTSET_MODE)
+		{
+			tree = NULL;
+			set = IntSet_Create(1, _maxKey(benchKeys, dist));
+		}
+		else tree = BST_CreateMode(treeMode | multiset);
+
+		if (!tree && !set)
+		{
+			printf("Cannot create a tree!\n");
+			return 100;
+		}
+
+		// same workload for every backend (the treap seed has been taken)
+		srand(BENCH_SEED);
+		ret = _bench(tree, set, benchKeys, dist, mix);
+		if (set) IntSet_Destroy(set);
+		else BST_Destroy(tree);
+		return ret;
+	}
+
 	FILE* fp;
 
-	if ((fp = fopen(argv[1], "rt")) == NULL)
+	if ((fp = fopen(argv[arg], "rt")) == NULL)
 	{
 		mode = RANDOM_INPUT;
 	}
@@ -115,7 +350,8 @@ int main(int argc, char** argv)
 
 	// creates a null tree
 	printf("create\n");
-	tree = BST_Create();
+	srand(time(NULL));
+	tree = BST_CreateMode(treeMode | multiset);
 
 	if (!tree)
 	{
@@ -126,12 +362,11 @@ int main(int argc, char** argv)
 	if (mode == RANDOM_INPUT)
 	{
 		int numbers;
-		numbers = atoi(argv[1]);
+		numbers = atoi(argv[arg]);
 		assert(numbers > 0);
 
 		fprintf(stdout, "Inserting: ");
 
-		srand(time(NULL));
 		for (int i = 0; i < numbers; i++)
 		{
 			data = rand() % (numbers * 3) + 1; // random number (1 ~ numbers * 3)
@@ -146,17 +381,30 @@ int main(int argc, char** argv)
 	}
 	else if (mode == FILE_INPUT)
 	{
-		fprintf(stdout, "Inserting: ");
+		int n;
+		int* keys = _readKeys(fp, &n);
+		fclose(fp);
 
-		while (fscanf(fp, "%d", &data) != EOF)
+		if (!keys)
 		{
-			fprintf(stdout, "%d ", data);
+			printf("Cannot read keys!\n");
+			BST_Destroy(tree);
+			return 100;
+		}
 
-			// insert function call
-			int ret = BST_Insert(tree, data);
-			if (!ret) break;
+		fprintf(stdout, "Inserting: ");
+		for (int i = 0; i < n; i++)
+			fprintf(stdout, "%d ", keys[i]);
+
+		// builds a balanced tree at once (O(n) after radix sort)
+		if (!BST_BuildFromArray(tree, keys, n))
+		{
+			printf("Cannot build a tree!\n");
+			free(keys);
+			BST_Destroy(tree);
+			return 100;
 		}
-		fclose(fp);
+		free(keys);
 	}
 
 	fprintf(stdout, "\n");
@@ -207,241 +455,3 @@ int main(int argc, char** argv)
 
 	return 0;
 }
-
-
-////////////////////////////////////////////////////////////////////////////////
-// Prototype declarations
-
-/* Allocates dynamic memory for a tree head node and returns its address to caller
-	return	head node pointer
-			NULL if overflow
-*/
-TREE* BST_Create(void) {
-	TREE* pTree = (TREE*)malloc(sizeof(TREE));
-	if (pTree == NULL) return NULL;
-
-	pTree->root = NULL;
-	return pTree;
-}
-
-/* Deletes all data in tree and recycles memory
-*/
-void BST_Destroy(TREE* pTree) {
-
-	if (pTree->root != NULL)
-		_destroy(pTree->root);
-
-	free(pTree);
-}
-
-/* internal function (not mandatory)
-*/
-static void _destroy(NODE* root) {
-
-	if (root != NULL) {
-		_destroy(root->left);
-		_destroy(root->right);
-		free(root);
-	}
-	return;
-}
-
-/* Inserts new data into the tree
-	return	1 success
-			0 overflow
-*/
-int BST_Insert(TREE* pTree, int data) {
-	NODE* pNode = _makeNode(data);
-	if (pNode == NULL) return 0;
-
-	if (pTree->root == NULL) {
-		pTree->root = pNode;
-		return 1;
-	}
-
-	_insert(pTree->root, pNode);
-	return 1;
-}
-
-/* internal function (not mandatory)
-*/
-static void _insert(NODE* root, NODE* newPtr) {
-	NODE* cur = root;
-	NODE* p = root;
-
-	while (cur != NULL) {
-		p = cur;
-		if (cur->data > newPtr->data)
-			cur = cur->left;
-		else
-			cur = cur->right;
-	}
-
-	if (p->data > newPtr->data) p->left = newPtr;
-	else p->right = newPtr;
-}
-
-NODE* _makeNode(int data) {
-	NODE* newNode = (NODE*)malloc(sizeof(NODE));
-	if (newNode == NULL) return NULL;
-
-	newNode->data = data;
-	newNode->right = NULL;
-	newNode->left = NULL;
-
-	return newNode;
-}
-
-/* Deletes a node with dltKey from the tree
-	return	1 success
-			0 not found
-*/
-int BST_Delete(TREE* pTree, int dltKey) {
-	int success;
-	NODE* tmp = NULL;
-	NODE* tmpp = NULL;
-
-	if (BST_Retrieve(pTree, dltKey) == NULL)
-		return 0;
-
-	pTree->root = _delete(pTree->root, dltKey, &success);
-
-	return success;
-}
-
-/* internal function
-	success is 1 if deleted; 0 if not
-	return	pointer to root
-*/
-static NODE* _delete(NODE* root, int dltKey, int* success) {
-	NODE* cur = root;
-	NODE* p = NULL;
-	NODE* tmp, * tmpp;
-
-	// find dltNode
-	while (cur != NULL) {
-		if (cur->data == dltKey) break;
-
-		p = cur;
-		if (cur->data > dltKey)
-			cur = cur->left;
-		else
-			cur = cur->right;
-	}
-
-	if (cur == NULL) {
-		*success = 0;
-		return root;
-	}
-
-	// 0 or 1 child
-	if (cur->left == NULL || cur->right == NULL) {
-		tmp = NULL;
-		if (cur->right != NULL)
-			tmp = cur->right;
-		else if (cur->left != NULL)
-			tmp = cur->left;
-
-		if (cur == root)
-			root = tmp;
-		else if (p->left == cur)
-			p->left = tmp;
-		else if (p->right == cur)
-			p->right = tmp;
-		free(cur);
-	}
-	// 2 children
-	else {
-		tmpp = cur;
-		tmp = cur->right;
-		while (tmp->left != NULL) {
-			tmpp = tmp;
-			tmp = tmp->left;
-		}
-		cur->data = tmp->data;
-
-		if (tmpp == cur)
-			tmpp->right = tmp->right;
-		else
-			tmpp->left = tmp->right;
-		free(tmp);
-	}
-
-	*success = 1;
-	return root;
-}
-
-/* Retrieve tree for the node containing the requested key
-	return	address of data of the node containing the key
-			NULL not found
-*/
-int* BST_Retrieve(TREE* pTree, int key) {
-	NODE* find = _retrieve(pTree->root, key);
-
-	if (find == NULL) return NULL;
-	else return &(find->data);
-}
-
-/* internal function
-	Retrieve node containing the requested key
-	return	address of the node containing the key
-			NULL not found
-*/
-static NODE* _retrieve(NODE* root, int key) {
-	NODE* cur = root;
-
-	while (cur != NULL) {
-		if (cur->data == key) break;
-
-		if (cur->data > key)
-			cur = cur->left;
-		else
-			cur = cur->right;
-	}
-
-	if (cur == NULL) return NULL;
-	else return cur;
-}
-
-/* prints tree using inorder traversal
-*/
-void BST_Traverse(TREE* pTree) {
-	if (pTree->root != NULL)
-		_traverse(pTree->root);
-}
-static void _traverse(NODE* root) {
-	if (root != NULL) {
-		printf("%d ", root->data);
-		_traverse(root->left);
-		_traverse(root->right);
-	}
-}
-
-/* Print tree using inorder right-to-left traversal
-*/
-void printTree(TREE* pTree) {
-	if (pTree->root != NULL)
-		_inorder_print(pTree->root, 0);
-}
-/* internal traversal function
-*/
-static void _inorder_print(NODE* root, int level) {
-	if (root->right != NULL)
-		_inorder_print(root->right, level + 1);
-
-	for (int i = 0; i < level; i++) printf("\t");
-	printf("%d\n", root->data);
-
-	if (root->left != NULL)
-		_inorder_print(root->left, level + 1);
-}
-
-/*
-	return 1 if the tree is empty; 0 if not
-*/
-int BST_Empty(TREE* pTree) {
-	if (pTree->root == NULL)
-		return 1;
-	else
-		return 0;
-}